@@ -0,0 +1,164 @@
+#include "bitboard.h"
+
+Bitboard knight_attack_table[SQUARE_COUNT];
+Bitboard king_attack_table[SQUARE_COUNT];
+Bitboard pawn_attack_table[2][SQUARE_COUNT];
+Bitboard between_table[SQUARE_COUNT][SQUARE_COUNT];
+Bitboard line_table[SQUARE_COUNT][SQUARE_COUNT];
+
+Magic rook_magics[SQUARE_COUNT];
+Magic bishop_magics[SQUARE_COUNT];
+
+namespace {
+    // Every relevant blocker subset of every square, fancy magics share one table.
+    Bitboard rook_table[0x19000];
+    Bitboard bishop_table[0x1480];
+
+    const int ROOK_DIRECTIONS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    const int BISHOP_DIRECTIONS[4][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+
+    // Walks the rays from p_square until the edge or the first blocker.
+    Bitboard sliding_attacks(int p_square, Bitboard p_occupied, const int p_directions[4][2]) {
+        Bitboard out = 0;
+        for (int i = 0; i < 4; i++) {
+            int row = square_row(p_square) + p_directions[i][0];
+            int col = square_col(p_square) + p_directions[i][1];
+            while (row >= 0 && row < 8 && col >= 0 && col < 8) {
+                Bitboard bb = square_bb(make_square(row, col));
+                out |= bb;
+                if (p_occupied & bb) {
+                    break;
+                }
+                row += p_directions[i][0];
+                col += p_directions[i][1];
+            }
+        }
+        return out;
+    }
+
+    // Board edges do not matter as blockers unless the slider stands on them.
+    Bitboard edges(int p_square) {
+        const Bitboard row_0 = 0xFFULL;
+        const Bitboard row_7 = row_0 << 56;
+        const Bitboard col_0 = 0x0101010101010101ULL;
+        const Bitboard col_7 = col_0 << 7;
+        Bitboard out = 0;
+        if (square_row(p_square) != 0) out |= row_0;
+        if (square_row(p_square) != 7) out |= row_7;
+        if (square_col(p_square) != 0) out |= col_0;
+        if (square_col(p_square) != 7) out |= col_7;
+        return out;
+    }
+
+    // xorshift64*, fixed seed so the tables are identical on every run.
+    Bitboard random_bitboard(Bitboard& p_state) {
+        p_state ^= p_state >> 12;
+        p_state ^= p_state << 25;
+        p_state ^= p_state >> 27;
+        return p_state * 2685821657736338717ULL;
+    }
+
+    void init_magics(Magic p_magics[], Bitboard p_table[], const int p_directions[4][2]) {
+        Bitboard occupancy[4096];
+        Bitboard reference[4096];
+        int epoch[4096] = {};
+        int current_epoch = 0;
+        Bitboard seed = 1070372;
+        Bitboard* attacks = p_table;
+
+        for (int square = 0; square < SQUARE_COUNT; square++) {
+            Magic& m = p_magics[square];
+            m.mask = sliding_attacks(square, 0, p_directions) & ~edges(square);
+            m.shift = 64 - popcount(m.mask);
+            m.attacks = attacks;
+
+            // Enumerate all subsets of the mask (Carry-Rippler).
+            int size = 0;
+            Bitboard subset = 0;
+            do {
+                occupancy[size] = subset;
+                reference[size] = sliding_attacks(square, subset, p_directions);
+                size++;
+                subset = (subset - m.mask) & m.mask;
+            } while (subset);
+
+            // Try sparse random numbers until one maps every subset without a
+            // destructive collision.
+            bool found = false;
+            while (!found) {
+                do {
+                    m.magic = random_bitboard(seed) & random_bitboard(seed) & random_bitboard(seed);
+                } while (popcount((m.mask * m.magic) >> 56) < 6);
+
+                current_epoch++;
+                found = true;
+                for (int i = 0; i < size; i++) {
+                    unsigned int index = m.index(occupancy[i]);
+                    if (epoch[index] < current_epoch) {
+                        epoch[index] = current_epoch;
+                        m.attacks[index] = reference[i];
+                    } else if (m.attacks[index] != reference[i]) {
+                        found = false;
+                        break;
+                    }
+                }
+            }
+            attacks += size;
+        }
+    }
+
+    // Squares reached by single steps, used for knights, kings and pawns.
+    Bitboard step_attacks(int p_square, const int p_steps[][2], int p_count) {
+        Bitboard out = 0;
+        for (int i = 0; i < p_count; i++) {
+            int row = square_row(p_square) + p_steps[i][0];
+            int col = square_col(p_square) + p_steps[i][1];
+            if (row >= 0 && row < 8 && col >= 0 && col < 8) {
+                out |= square_bb(make_square(row, col));
+            }
+        }
+        return out;
+    }
+
+    void init_step_attacks() {
+        const int knight_steps[8][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
+        const int king_steps[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+        // white pawns move towards row 0, black pawns towards row 7
+        const int pawn_steps[2][2][2] = {{{-1, -1}, {-1, 1}}, {{1, -1}, {1, 1}}};
+        for (int square = 0; square < SQUARE_COUNT; square++) {
+            knight_attack_table[square] = step_attacks(square, knight_steps, 8);
+            king_attack_table[square] = step_attacks(square, king_steps, 8);
+            pawn_attack_table[0][square] = step_attacks(square, pawn_steps[0], 2);
+            pawn_attack_table[1][square] = step_attacks(square, pawn_steps[1], 2);
+        }
+    }
+
+    void init_lines() {
+        for (int from = 0; from < SQUARE_COUNT; from++) {
+            for (int to = 0; to < SQUARE_COUNT; to++) {
+                between_table[from][to] = 0;
+                line_table[from][to] = 0;
+                if (from == to) {
+                    continue;
+                }
+                const Bitboard to_bb = square_bb(to);
+                if (rook_attacks(from, 0) & to_bb) {
+                    line_table[from][to] = (rook_attacks(from, 0) & rook_attacks(to, 0)) | square_bb(from) | to_bb;
+                    between_table[from][to] = rook_attacks(from, to_bb) & rook_attacks(to, square_bb(from));
+                } else if (bishop_attacks(from, 0) & to_bb) {
+                    line_table[from][to] = (bishop_attacks(from, 0) & bishop_attacks(to, 0)) | square_bb(from) | to_bb;
+                    between_table[from][to] = bishop_attacks(from, to_bb) & bishop_attacks(to, square_bb(from));
+                }
+            }
+        }
+    }
+
+    struct AttackTablesInit {
+        AttackTablesInit() {
+            init_step_attacks();
+            init_magics(rook_magics, rook_table, ROOK_DIRECTIONS);
+            init_magics(bishop_magics, bishop_table, BISHOP_DIRECTIONS);
+            init_lines();
+        }
+    } attack_tables_init;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <bit>
+
+// One bit per square. Squares are indexed in the same order as the board
+// array of Position: square = row * 8 + col, so 0 is "a8" and 63 is "h1".
+typedef uint64_t Bitboard;
+
+const int SQUARE_COUNT = 64;
+
+inline int make_square(int p_row, int p_col) { return p_row * 8 + p_col; }
+inline int square_row(int p_square) { return p_square >> 3; }
+inline int square_col(int p_square) { return p_square & 7; }
+
+inline Bitboard square_bb(int p_square) { return 1ULL << p_square; }
+
+inline int popcount(Bitboard p_bitboard) { return std::popcount(p_bitboard); }
+inline int lsb(Bitboard p_bitboard) { return std::countr_zero(p_bitboard); }
+
+// Returns the lowest set square and clears it from the bitboard.
+inline int pop_lsb(Bitboard& p_bitboard) {
+  int square = lsb(p_bitboard);
+  p_bitboard &= p_bitboard - 1;
+  return square;
+}
+
+extern Bitboard knight_attack_table[SQUARE_COUNT];
+extern Bitboard king_attack_table[SQUARE_COUNT];
+extern Bitboard pawn_attack_table[2][SQUARE_COUNT];
+extern Bitboard between_table[SQUARE_COUNT][SQUARE_COUNT];
+extern Bitboard line_table[SQUARE_COUNT][SQUARE_COUNT];
+
+inline Bitboard knight_attacks(int p_square) { return knight_attack_table[p_square]; }
+inline Bitboard king_attacks(int p_square) { return king_attack_table[p_square]; }
+// Squares a pawn of p_player standing on p_square can capture on.
+inline Bitboard pawn_attacks(int p_player, int p_square) { return pawn_attack_table[p_player][p_square]; }
+
+// Squares strictly between two squares on a common row, column or
+// diagonal, empty if they are not aligned.
+inline Bitboard between_bb(int p_from, int p_to) { return between_table[p_from][p_to]; }
+// Whole row, column or diagonal through both squares, empty if they are
+// not aligned.
+inline Bitboard line_bb(int p_from, int p_to) { return line_table[p_from][p_to]; }
+
+// Magic bitboard entry of one square. The attack set of a slider is found by
+// masking the relevant blockers, multiplying by the magic number and using
+// the top bits of the product as an index into the precomputed attacks.
+struct Magic {
+  Bitboard mask;
+  Bitboard magic;
+  Bitboard* attacks;
+  int shift;
+
+  unsigned int index(Bitboard p_occupied) const {
+    return (unsigned int)(((p_occupied & mask) * magic) >> shift);
+  }
+};
+
+extern Magic rook_magics[SQUARE_COUNT];
+extern Magic bishop_magics[SQUARE_COUNT];
+
+// Squares attacked by a slider from p_square, blockers included.
+// The tables are built once at startup.
+inline Bitboard rook_attacks(int p_square, Bitboard p_occupied) {
+  const Magic& m = rook_magics[p_square];
+  return m.attacks[m.index(p_occupied)];
+}
+
+inline Bitboard bishop_attacks(int p_square, Bitboard p_occupied) {
+  const Magic& m = bishop_magics[p_square];
+  return m.attacks[m.index(p_occupied)];
+}
+
+inline Bitboard queen_attacks(int p_square, Bitboard p_occupied) {
+  return rook_attacks(p_square, p_occupied) | bishop_attacks(p_square, p_occupied);
+}
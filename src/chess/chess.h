@@ -24,6 +24,9 @@ enum {
   NA // Not available (empty cell)
 };
 
+// Piece of the given player matching a white piece code, e.g. (BLACK, wN) -> bN.
+inline int get_player_piece(int p_player, int p_white_piece) { return p_player == WHITE ? p_white_piece : p_white_piece + bR; }
+
 std::string chess_piece_to_string(int p_index);
 int get_chess_piece_color(int p_index);
 bool is_promotable(int p_piece, int p_destination_row);
@@ -1,11 +1,39 @@
 #include "move.h"
 
-string Move::get_coords() const {
+// Promotion pieces in the order of the promotion bits.
+static const int WHITE_PROMOTIONS[4] = {wN, wB, wR, wQ};
+static const int BLACK_PROMOTIONS[4] = {bN, bB, bR, bQ};
+
+string Move::get_coords(const bool with_promotion) const {
     std::string out = "";
     const std::string letters = "abcdefgh";
-    out += letters[m_start_pos[1]];
-    out += to_string(7-m_start_pos[0] + 1);
-    out += letters[m_end_pos[1]];
-    out += to_string(7-m_end_pos[0] + 1);
+    out += letters[get_start_pos()[1]];
+    out += to_string(7-get_start_pos()[0] + 1);
+    out += letters[get_end_pos()[1]];
+    out += to_string(7-get_end_pos()[0] + 1);
+    if (with_promotion && get_type() == PROMOTION) {
+        out += "nbrq"[(m_data >> 12) & 3];
+    }
     return out;
-}
\ No newline at end of file
+}
+
+void Move::set_promotable(int p_chess_piece) {
+    if (p_chess_piece == NA) {
+        m_data &= 0x0FFF;
+        return;
+    }
+    for (int i = 0; i < 4; i++) {
+        if (WHITE_PROMOTIONS[i] == p_chess_piece || BLACK_PROMOTIONS[i] == p_chess_piece) {
+            set_promotion_type(i);
+        }
+    }
+}
+
+int Move::get_promotable() const {
+    if (get_type() != PROMOTION) {
+        return NA;
+    }
+    // white promotes on row 0, black on row 7
+    int type = (m_data >> 12) & 3;
+    return get_end_pos()[0] == 0 ? WHITE_PROMOTIONS[type] : BLACK_PROMOTIONS[type];
+}
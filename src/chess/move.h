@@ -3,45 +3,97 @@
 #include <string>
 #include <cctype>
 #include <array>
+#include <cstdint>
 #include "chess.h"
 using namespace std;
 
 // Describes change in position.
+//
+// Packed into 16 bits:
+// bits 0-5   : start square (row * 8 + col)
+// bits 6-11  : end square
+// bits 12-13 : promotion piece, 0 = knight, 1 = bishop, 2 = rook, 3 = queen
+// bits 14-15 : move type (NORMAL_MOVE, PROMOTION, EN_PASSANT, CASTLING)
+//
+// A default constructed move (all zero) is the null move.
 class Move {
 public: 
-    Move() {};
-    Move(array<int, 2> start_pos, array<int, 2> end_pos) {
-        m_start_pos[0] = start_pos[0];
-        m_start_pos[1] = start_pos[1];
+    enum { NORMAL_MOVE = 0, PROMOTION = 1, EN_PASSANT = 2, CASTLING = 3 };
 
-        m_end_pos[0] = end_pos[0];
-        m_end_pos[1] = end_pos[1];
+    Move() {};
+    Move(int p_start_square, int p_end_square, int p_type = NORMAL_MOVE) {
+        m_data = (uint16_t)(p_start_square | (p_end_square << 6) | (p_type << 14));
     }
+    Move(array<int, 2> start_pos, array<int, 2> end_pos)
+        : Move(start_pos[0] * 8 + start_pos[1], end_pos[0] * 8 + end_pos[1]) {}
     Move(const string& s)
     {
         //changes the numbers in the string to int and subtracts from 8 to reverse the order
-        m_start_pos[0] = 8 - stoi(string(1, s[1]));
-        m_end_pos[0] = 8 - stoi(string(1, s[3]));
+        int start_row = 8 - stoi(string(1, s[1]));
+        int end_row = 8 - stoi(string(1, s[3]));
 
         //changes the letters in the string to integers that correspond with alphabetical order
         const string alph_order = "abcdefgh";
+        int start_col = 0;
+        int end_col = 0;
         if (isalnum(s[0]))
         {
-            m_start_pos[1] = alph_order.find(tolower(s[0]));
+            start_col = alph_order.find(tolower(s[0]));
         }
         if (isalnum(s[2]))
         {
-            m_end_pos[1] = alph_order.find(tolower(s[2]));
+            end_col = alph_order.find(tolower(s[2]));
+        }
+        *this = Move(start_row * 8 + start_col, end_row * 8 + end_col);
+
+        // optional promotion letter, e.g. "a7a8q"
+        const string promotion_order = "nbrq";
+        if (s.size() > 4 && promotion_order.find(tolower(s[4])) != string::npos) {
+            set_promotion_type(promotion_order.find(tolower(s[4])));
         }
     }
-    string get_coords() const;
-    std::array<int, 2> get_start_pos() const {return {m_start_pos[0], m_start_pos[1]};};
-    std::array<int, 2> get_end_pos() const {return {m_end_pos[0], m_end_pos[1]};};
-    void set_promotable(int p_chess_piece) {promotable_piece = p_chess_piece;};
-    int get_promotable() const {return promotable_piece;}
+    // "e2e4" form, with_promotion appends the promotion letter ("a7a8q").
+    string get_coords(const bool with_promotion = false) const;
+    int get_start_square() const { return m_data & 0x3F; }
+    int get_end_square() const { return (m_data >> 6) & 0x3F; }
+    int get_type() const { return m_data >> 14; }
+    std::array<int, 2> get_start_pos() const {return {get_start_square() >> 3, get_start_square() & 7};};
+    std::array<int, 2> get_end_pos() const {return {get_end_square() >> 3, get_end_square() & 7};};
+    // Takes a chess piece (wQ, bN, ...) or NA to clear the promotion.
+    void set_promotable(int p_chess_piece);
+    // Promotion chess piece, the color follows from the end row. NA if none.
+    int get_promotable() const;
+    bool is_null() const { return m_data == 0; }
+    uint16_t get_data() const { return m_data; }
+    // Rebuilds a move from get_data(), e.g. when stored in a table.
+    static Move from_data(uint16_t p_data) { Move move; move.m_data = p_data; return move; }
+    bool operator==(const Move& p_other) const { return m_data == p_other.m_data; }
+    bool operator!=(const Move& p_other) const { return m_data != p_other.m_data; }
 private: 
-    // rows and cols
-    int m_start_pos[2];
-    int m_end_pos[2];
-    int promotable_piece = NA;
-};
\ No newline at end of file
+    void set_promotion_type(int p_type) {
+        m_data = (uint16_t)((m_data & 0x0FFF) | (p_type << 12) | (PROMOTION << 14));
+    }
+
+    uint16_t m_data = 0;
+};
+
+// Upper bound for the number of moves in any chess position.
+const int MAX_MOVES = 256;
+
+// Fixed capacity move container meant to live on the stack. Move
+// generators append into it, so generating moves never touches the heap.
+class MoveList {
+public:
+    void push_back(const Move& p_move) { m_moves[m_size++] = p_move; }
+    void clear() { m_size = 0; }
+    int size() const { return m_size; }
+    Move& operator[](int p_index) { return m_moves[p_index]; }
+    const Move& operator[](int p_index) const { return m_moves[p_index]; }
+    Move* begin() { return m_moves; }
+    Move* end() { return m_moves + m_size; }
+    const Move* begin() const { return m_moves; }
+    const Move* end() const { return m_moves + m_size; }
+private:
+    Move m_moves[MAX_MOVES];
+    int m_size = 0;
+};
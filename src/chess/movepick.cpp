@@ -0,0 +1,191 @@
+#include "movepick.h"
+#include "position.h"
+
+namespace {
+    // Piece values for move ordering, indexed by chess piece. Kings are never
+    // captured, as attackers they go last.
+    const int ORDER_VALUES[13] = {
+        5, 3, 3, 9, 20, 1,
+        5, 3, 3, 9, 20, 1,
+        0
+    };
+    // Captures and promotions are scored above every quiet move in evasions.
+    const int EVASION_CAPTURE_BONUS = 1 << 20;
+}
+
+void ButterflyHistory::add(int p_player, const Move& p_move, int p_bonus) {
+    int& score = scores[p_player][p_move.get_start_square()][p_move.get_end_square()];
+    score += p_bonus;
+    // keep far away from overflow on long searches
+    if (score > (1 << 24)) {
+        age();
+    }
+}
+
+void ButterflyHistory::age() {
+    for (int player = 0; player < 2; player++) {
+        for (int from = 0; from < SQUARE_COUNT; from++) {
+            for (int to = 0; to < SQUARE_COUNT; to++) {
+                scores[player][from][to] /= 2;
+            }
+        }
+    }
+}
+
+MovePicker::MovePicker(const Position& p_pos, Move p_hash_move, const Move* p_killers, const ButterflyHistory* p_history) : m_pos(p_pos), m_history(p_history) {
+    m_stage = p_pos.is_in_check(p_pos.get_moving_player()) ? EVASION_HASH_MOVE : HASH_MOVE;
+    m_hash_move = p_hash_move;
+    if (p_killers) {
+        m_killers[0] = p_killers[0];
+        m_killers[1] = p_killers[1];
+    }
+}
+
+MovePicker::MovePicker(const Position& p_pos) : m_pos(p_pos) {
+    m_stage = p_pos.is_in_check(p_pos.get_moving_player()) ? EVASION_HASH_MOVE : GENERATE_CAPTURES;
+    m_captures_only = true;
+}
+
+Move MovePicker::pick_best() {
+    int best = m_current;
+    for (int i = m_current + 1; i < m_moves.size(); i++) {
+        if (m_scores[i] > m_scores[best]) {
+            best = i;
+        }
+    }
+    std::swap(m_moves[best], m_moves[m_current]);
+    std::swap(m_scores[best], m_scores[m_current]);
+    return m_moves[m_current++];
+}
+
+int MovePicker::score_capture(const Move& p_move) const {
+    int attacker = m_pos.get_piece(p_move.get_start_pos()[0], p_move.get_start_pos()[1]);
+    int victim = m_pos.get_piece(p_move.get_end_pos()[0], p_move.get_end_pos()[1]);
+    if (p_move.get_type() == Move::EN_PASSANT) {
+        victim = wP;
+    }
+    int score = ORDER_VALUES[victim] * 32 - ORDER_VALUES[attacker];
+    if (p_move.get_type() == Move::PROMOTION) {
+        score += ORDER_VALUES[p_move.get_promotable()] * 32;
+    }
+    return score;
+}
+
+// The hash move and killers are tried before their own stage, so skip them there.
+bool MovePicker::is_special(const Move& p_move) const {
+    return p_move == m_hash_move || p_move == m_killers[0] || p_move == m_killers[1];
+}
+
+Move MovePicker::next_move() {
+    while (true) {
+        switch (m_stage) {
+            case HASH_MOVE:
+            case EVASION_HASH_MOVE: {
+                m_stage++;
+                if (m_pos.is_legal(m_hash_move)) {
+                    return m_hash_move;
+                }
+                break;
+            }
+            case GENERATE_CAPTURES: {
+                m_moves.clear();
+                m_current = 0;
+                m_pos.generate_legal_moves(m_moves, true, CAPTURES);
+                for (int i = 0; i < m_moves.size(); i++) {
+                    m_scores[i] = score_capture(m_moves[i]);
+                }
+                m_stage++;
+                break;
+            }
+            case GOOD_CAPTURES: {
+                while (m_current < m_moves.size()) {
+                    Move move = pick_best();
+                    if (move == m_hash_move) {
+                        continue;
+                    }
+                    // losing captures wait until the quiet moves are done, taking a
+                    // piece worth at least the attacker can't lose material
+                    int attacker = m_pos.get_piece(move.get_start_pos()[0], move.get_start_pos()[1]);
+                    int victim = m_pos.get_piece(move.get_end_pos()[0], move.get_end_pos()[1]);
+                    if (move.get_type() == Move::NORMAL_MOVE && ORDER_VALUES[attacker] > ORDER_VALUES[victim] && m_pos.see(move) < 0) {
+                        if (!m_captures_only) {
+                            m_bad_captures.push_back(move);
+                        }
+                        continue;
+                    }
+                    return move;
+                }
+                m_stage = m_captures_only ? DONE : KILLERS;
+                break;
+            }
+            case KILLERS: {
+                while (m_killer_index < 2) {
+                    Move killer = m_killers[m_killer_index++];
+                    if (killer != m_hash_move && !m_pos.is_capture(killer) && killer.get_type() != Move::PROMOTION && m_pos.is_legal(killer)) {
+                        return killer;
+                    }
+                }
+                m_stage++;
+                break;
+            }
+            case GENERATE_QUIETS: {
+                m_moves.clear();
+                m_current = 0;
+                m_pos.generate_legal_moves(m_moves, true, QUIETS);
+                int player = m_pos.get_moving_player();
+                for (int i = 0; i < m_moves.size(); i++) {
+                    m_scores[i] = m_history ? m_history->get(player, m_moves[i]) : 0;
+                }
+                m_stage++;
+                break;
+            }
+            case QUIET_MOVES: {
+                while (m_current < m_moves.size()) {
+                    Move move = m_history ? pick_best() : m_moves[m_current++];
+                    if (!is_special(move)) {
+                        return move;
+                    }
+                }
+                m_current = 0;
+                m_stage++;
+                break;
+            }
+            case BAD_CAPTURES: {
+                if (m_current < m_bad_captures.size()) {
+                    return m_bad_captures[m_current++];
+                }
+                m_stage = DONE;
+                break;
+            }
+            case GENERATE_EVASIONS: {
+                m_moves.clear();
+                m_current = 0;
+                m_pos.generate_legal_moves(m_moves, true, ALL_MOVES);
+                // captures of the checker first
+                int player = m_pos.get_moving_player();
+                for (int i = 0; i < m_moves.size(); i++) {
+                    const Move& move = m_moves[i];
+                    if (m_pos.is_capture(move) || move.get_type() == Move::PROMOTION) {
+                        m_scores[i] = EVASION_CAPTURE_BONUS + score_capture(move);
+                    } else {
+                        m_scores[i] = m_history ? m_history->get(player, move) : 0;
+                    }
+                }
+                m_stage++;
+                break;
+            }
+            case EVASIONS: {
+                while (m_current < m_moves.size()) {
+                    Move move = pick_best();
+                    if (move != m_hash_move) {
+                        return move;
+                    }
+                }
+                m_stage = DONE;
+                break;
+            }
+            case DONE:
+                return Move();
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "move.h"
+#include "bitboard.h"
+
+class Position;
+
+// Butterfly history: a score for every quiet move by player, start and end
+// square, raised each time the move causes a cut-off. Quiet moves are tried
+// in order of their history.
+struct ButterflyHistory {
+  int scores[2][SQUARE_COUNT][SQUARE_COUNT] = {};
+
+  int get(int p_player, const Move& p_move) const {
+    return scores[p_player][p_move.get_start_square()][p_move.get_end_square()];
+  }
+  void add(int p_player, const Move& p_move, int p_bonus);
+  // Halves all scores so old cut-offs weigh less than new ones.
+  void age();
+};
+
+// Hands out the legal moves of a position one at a time for the search,
+// best candidates first. Moves are generated in stages and a stage is only
+// generated once the previous one is used up, so a cut-off after the first
+// moves never pays for generating the quiet moves.
+class MovePicker {
+public:
+  // p_hash_move and p_killers (two slots, may be nullptr) come from other
+  // positions and are only returned if legal here. p_history may be nullptr.
+  MovePicker(const Position& p_pos, Move p_hash_move, const Move* p_killers, const ButterflyHistory* p_history);
+  // Captures and promotions only, for the quiescence search. Losing captures
+  // are left out. In check all evasions are returned like above.
+  MovePicker(const Position& p_pos);
+
+  // Null move when there are no moves left.
+  Move next_move();
+
+private:
+  enum Stage {
+    HASH_MOVE,
+    GENERATE_CAPTURES,
+    GOOD_CAPTURES,
+    KILLERS,
+    GENERATE_QUIETS,
+    QUIET_MOVES,
+    BAD_CAPTURES,
+    EVASION_HASH_MOVE,
+    GENERATE_EVASIONS,
+    EVASIONS,
+    DONE
+  };
+
+  // Returns the best scored move left in m_moves and removes it.
+  Move pick_best();
+  bool is_special(const Move& p_move) const;
+
+  // Most valuable victim first, cheapest attacker first among equal victims.
+  int score_capture(const Move& p_move) const;
+
+  const Position& m_pos;
+  const ButterflyHistory* m_history = nullptr;
+  int m_stage;
+  bool m_captures_only = false;
+  Move m_hash_move;
+  Move m_killers[2];
+  int m_killer_index = 0;
+
+  MoveList m_moves;
+  int m_scores[MAX_MOVES];
+  int m_current = 0;
+  MoveList m_bad_captures;
+};
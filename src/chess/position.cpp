@@ -1,149 +1,552 @@
 #include "position.h"
+#include "search.h"
+#include "zobrist.h"
 #include <iostream>
 #include <cmath>
 #include <limits>
-#include <map>
-#include <future>
 #include <algorithm>
+#include <sstream>
+#include <cassert>
+
+// Initial board layout, get_board() returns the same layout for this position.
+static const std::array<std::array<int, 8>, 8> START_BOARD = {{
+    {bR, bN, bB, bQ, bK, bB, bN, bR},
+    {bP, bP, bP, bP, bP, bP, bP, bP}, 
+    {NA, NA, NA, NA, NA, NA, NA, NA},
+    {NA, NA, NA, NA, NA, NA, NA, NA},
+    {NA, NA, NA, NA, NA, NA, NA, NA},
+    {NA, NA, NA, NA, NA, NA, NA, NA},
+    {wP, wP, wP, wP, wP, wP, wP, wP},
+    {wR, wN, wB, wQ, wK, wB, wN, wR}, 
+}};
+
+Position::Position() {
+    clear();
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            put_piece(START_BOARD[row][col], make_square(row, col));
+        }
+    }
+    m_key = compute_key();
+}
 
 void Position::clear() {
-    for (int rows = 0; rows < 8; rows ++) {
-        for (int cols = 0; cols < 8; cols ++) {
-            m_board[rows][cols] = NA;
-        }
-    }
-}
-
-std::vector<Move> Position::get_all_raw_moves(int player) const {
-    std::vector<Move> out;
-	for (int row = 0; row < 8; row++) {
-		for (int col = 0; col < 8; col++)
-		{
-			int chess_piece = m_board[row][col];
-
-			if (chess_piece == NA)
-				continue;
-
-			if (get_chess_piece_color(chess_piece) != player)
-				continue;
-
-            std::vector<Move> temp;
-			switch (chess_piece)
-			{
-			case wR: case bR:
-                temp = get_rook_raw_move(row, col, player);
-				break;
-			case wQ: case bQ:
-				temp = get_queen_raw_move(row, col, player);
-				break;
-			case wN: case bN:
-				temp = get_knight_raw_move(row, col, player);
-				break;
-			case wB: case bB:
-				temp = get_bishop_raw_move(row, col, player);
-				break;
-			case wK: case bK:
-				temp = get_king_raw_move(row, col, player);
-				break;
-			case wP: case bP:
-				temp = get_pawn_raw_move(row, col, player);
-				break;
-			}
-            if (temp.size() > 0) {
-                out.insert(out.end(), temp.begin(), temp.end());
+    for (int i = 0; i < 12; i++) {
+        m_pieces[i] = 0;
+    }
+    m_occupancy[WHITE] = 0;
+    m_occupancy[BLACK] = 0;
+    m_squares.fill(NA);
+    for (int i = 0; i < 12; i++) {
+        m_piece_count[i] = 0;
+    }
+    m_key = 0;
+}
+
+bool Position::set_fen(const std::string& p_fen) {
+    static const std::string PIECE_LETTERS = "RNBQKPrnbqkp";
+    std::istringstream stream(p_fen);
+    std::string placement, turn, castlings, en_passant;
+    if (!(stream >> placement >> turn >> castlings >> en_passant)) {
+        return false;
+    }
+
+    clear();
+    int row = 0;
+    int col = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            row++;
+            col = 0;
+        }
+        else if (c >= '1' && c <= '8') {
+            col += c - '0';
+        }
+        else {
+            size_t chess_piece = PIECE_LETTERS.find(c);
+            if (chess_piece == std::string::npos || row > 7 || col > 7) {
+                return false;
             }
-		}
+            put_piece((int)chess_piece, make_square(row, col));
+            col++;
+        }
+    }
+    if (m_piece_count[wK] != 1 || m_piece_count[bK] != 1) {
+        return false;
+    }
+
+    m_movingturn = turn == "b" ? BLACK : WHITE;
+
+    m_castling_rights = 0;
+    for (char c : castlings) {
+        switch (c) {
+        case 'K': m_castling_rights |= WHITE_SHORT_CASTLING; break;
+        case 'Q': m_castling_rights |= WHITE_LONG_CASTLING; break;
+        case 'k': m_castling_rights |= BLACK_SHORT_CASTLING; break;
+        case 'q': m_castling_rights |= BLACK_LONG_CASTLING; break;
+        }
     }
 
-    return out;
-        
+    // the en passant column is stored for the player whose pawn just made the double step
+    m_en_passant_col[WHITE] = -1;
+    m_en_passant_col[BLACK] = -1;
+    if (en_passant.size() == 2 && en_passant[0] >= 'a' && en_passant[0] <= 'h') {
+        m_en_passant_col[m_movingturn == WHITE ? BLACK : WHITE] = en_passant[0] - 'a';
+    }
+    m_undo_count = 0;
+    m_key = compute_key();
+    return true;
 }
 
-void Position::get_chess_piece(int chess_piece, int& row, int& col) const {
-    for (int i = 0; i < 8; ++i) {
-        for (int j = 0; j < 8; ++j) {
-            if (chess_piece == m_board[i][j]) {
-                row = i; 
-                col = j;
-                return;
-            }
+void Position::put_piece(int chess_piece, int square) {
+    if (chess_piece == NA) {
+        return;
+    }
+    Bitboard bb = square_bb(square);
+    m_pieces[chess_piece] |= bb;
+    m_occupancy[get_chess_piece_color(chess_piece)] |= bb;
+    m_squares[square] = chess_piece;
+    m_key ^= ZOBRIST.pieces[chess_piece][square];
+    m_piece_index[square] = m_piece_count[chess_piece];
+    m_piece_list[chess_piece][m_piece_count[chess_piece]++] = square;
+    if (chess_piece == wK || chess_piece == bK) {
+        m_king_square[get_chess_piece_color(chess_piece)] = square;
+    }
+}
+
+void Position::remove_piece(int square) {
+    int chess_piece = m_squares[square];
+    if (chess_piece == NA) {
+        return;
+    }
+    Bitboard bb = square_bb(square);
+    m_pieces[chess_piece] &= ~bb;
+    m_occupancy[get_chess_piece_color(chess_piece)] &= ~bb;
+    m_squares[square] = NA;
+    m_key ^= ZOBRIST.pieces[chess_piece][square];
+    // fill the hole in the piece list with its last square
+    int last_square = m_piece_list[chess_piece][--m_piece_count[chess_piece]];
+    m_piece_index[last_square] = m_piece_index[square];
+    m_piece_list[chess_piece][m_piece_index[square]] = last_square;
+}
+
+std::array<std::array<int, 8>, 8> Position::get_board() const {
+    std::array<std::array<int, 8>, 8> board;
+    for (int row = 0; row < 8; row++) {
+        board[row].fill(NA);
+    }
+    for (int chess_piece = wR; chess_piece < NA; chess_piece++) {
+        Bitboard pieces = m_pieces[chess_piece];
+        while (pieces) {
+            int square = pop_lsb(pieces);
+            board[square_row(square)][square_col(square)] = chess_piece;
+        }
+    }
+    return board;
+}
+
+uint64_t Position::compute_key() const {
+    uint64_t key = 0;
+    for (int chess_piece = wR; chess_piece < NA; chess_piece++) {
+        for (int i = 0; i < m_piece_count[chess_piece]; i++) {
+            key ^= ZOBRIST.pieces[chess_piece][m_piece_list[chess_piece][i]];
+        }
+    }
+    key ^= ZOBRIST.castling[m_castling_rights];
+    for (int player = WHITE; player <= BLACK; player++) {
+        if (m_en_passant_col[player] != -1) {
+            key ^= ZOBRIST.en_passant[m_en_passant_col[player]];
+        }
+    }
+    if (m_movingturn == BLACK) {
+        key ^= ZOBRIST.black_to_move;
+    }
+    return key;
+}
+
+void Position::get_all_raw_moves(int player, MoveList& out) const {
+    Bitboard pieces = m_occupancy[player];
+    while (pieces) {
+        int square = pop_lsb(pieces);
+        int row = square_row(square);
+        int col = square_col(square);
+        int chess_piece = m_squares[square];
+
+        switch (chess_piece)
+        {
+        case wR: case bR:
+            get_rook_raw_move(row, col, player, out);
+            break;
+        case wQ: case bQ:
+            get_queen_raw_move(row, col, player, out);
+            break;
+        case wN: case bN:
+            get_knight_raw_move(row, col, player, out);
+            break;
+        case wB: case bB:
+            get_bishop_raw_move(row, col, player, out);
+            break;
+        case wK: case bK:
+            get_king_raw_move(row, col, player, out);
+            break;
+        case wP: case bP:
+            get_pawn_raw_move(row, col, player, out);
+            break;
         }
     }
 }
 
+void Position::get_chess_piece(int chess_piece, int& row, int& col) const {
+    if (m_piece_count[chess_piece] > 0) {
+        int square = m_piece_list[chess_piece][0];
+        row = square_row(square);
+        col = square_col(square);
+    }
+}
+
+Bitboard Position::attackers_to(int square, Bitboard occupied) const {
+    Bitboard rooks = m_pieces[wR] | m_pieces[bR] | m_pieces[wQ] | m_pieces[bQ];
+    Bitboard bishops = m_pieces[wB] | m_pieces[bB] | m_pieces[wQ] | m_pieces[bQ];
+    // A white pawn attacks the square if a black pawn on the square would
+    // attack the white pawn, and the other way around.
+    return (pawn_attacks(BLACK, square) & m_pieces[wP])
+         | (pawn_attacks(WHITE, square) & m_pieces[bP])
+         | (knight_attacks(square) & (m_pieces[wN] | m_pieces[bN]))
+         | (king_attacks(square) & (m_pieces[wK] | m_pieces[bK]))
+         | (rook_attacks(square, occupied) & rooks)
+         | (bishop_attacks(square, occupied) & bishops);
+}
+
 bool Position::is_square_threatened(int row, int col, int threatening_player) const {
-    vector<Move> moves = get_all_raw_moves(threatening_player);
-    for (int i=0; i < moves.size(); ++i) {
-        const Move& move = moves[i];
-        int chess_piece = m_board[move.get_start_pos()[0]][move.get_start_pos()[1]];
-        if (chess_piece == wP) {
-            if (move.get_start_pos()[0] - 1 == row && (move.get_start_pos()[1] + 1 == col || move.get_start_pos()[1] - 1 == col))
-                return true;
+    return attackers_to(make_square(row, col), get_occupied()) & m_occupancy[threatening_player];
+}
+
+bool Position::is_in_check(int player) const {
+    int opponent = player == WHITE ? BLACK : WHITE;
+    int king_square = m_king_square[player];
+    return attackers_to(king_square, get_occupied()) & m_occupancy[opponent];
+}
+
+Bitboard Position::get_pinned(int player, int king_square) const {
+    int opponent = player == WHITE ? BLACK : WHITE;
+    Bitboard occupied = get_occupied();
+    Bitboard rooks = m_pieces[get_player_piece(opponent, wR)] | m_pieces[get_player_piece(opponent, wQ)];
+    Bitboard bishops = m_pieces[get_player_piece(opponent, wB)] | m_pieces[get_player_piece(opponent, wQ)];
+    // enemy sliders that would see the king if our own pieces were not there
+    Bitboard snipers = (rook_attacks(king_square, m_occupancy[opponent]) & rooks)
+                     | (bishop_attacks(king_square, m_occupancy[opponent]) & bishops);
+    Bitboard pinned = 0;
+    while (snipers) {
+        int sniper = pop_lsb(snipers);
+        Bitboard blockers = between_bb(king_square, sniper) & occupied;
+        if (popcount(blockers) == 1 && (blockers & m_occupancy[player])) {
+            pinned |= blockers;
         }
-        else if (chess_piece == bP) {
-            if (move.get_start_pos()[0] + 1 == row && (move.get_start_pos()[1] + 1 == col || move.get_start_pos()[1] - 1 == col))
-                return true;
+    }
+    return pinned;
+}
+
+Bitboard Position::get_gen_type_target(const int gen_type) const {
+    int opponent = m_movingturn == WHITE ? BLACK : WHITE;
+    switch (gen_type) {
+    case CAPTURES:
+        return m_occupancy[opponent];
+    case QUIETS:
+        return ~get_occupied();
+    default:
+        return ~m_occupancy[m_movingturn];
+    }
+}
+
+void Position::generate_legal_moves(MoveList& out, const bool ai_legal_moves, const int gen_type) const {
+    int player = m_movingturn;
+    int opponent = player == WHITE ? BLACK : WHITE;
+    int king_square = m_king_square[player];
+    Bitboard checkers = attackers_to(king_square, get_occupied()) & m_occupancy[opponent];
+    Bitboard pinned = get_pinned(player, king_square);
+
+    if (checkers) {
+        generate_evasions(out, checkers, pinned, ai_legal_moves, gen_type);
+        return;
+    }
+    add_piece_moves(out, ~m_occupancy[player], pinned, ai_legal_moves, gen_type);
+    add_king_moves(out, get_gen_type_target(gen_type));
+    if (gen_type != CAPTURES) {
+        get_castlings(player, out);
+    }
+}
+
+void Position::generate_evasions(MoveList& out, Bitboard checkers, Bitboard pinned, const bool ai_legal_moves, const int gen_type) const {
+    int player = m_movingturn;
+    int king_square = m_king_square[player];
+    add_king_moves(out, get_gen_type_target(gen_type));
+    // against a double check only the king can move
+    if (popcount(checkers) > 1) {
+        return;
+    }
+    // otherwise capture the checker or block its ray
+    int checker = lsb(checkers);
+    add_piece_moves(out, checkers | between_bb(king_square, checker), pinned, ai_legal_moves, gen_type);
+}
+
+void Position::add_piece_moves(MoveList& out, Bitboard target, Bitboard pinned, const bool ai_legal_moves, const int gen_type) const {
+    int player = m_movingturn;
+    int king_square = m_king_square[player];
+    Bitboard occupied = get_occupied();
+    // pawns sort promotions and captures out themselves
+    Bitboard pawn_target = target;
+    target &= get_gen_type_target(gen_type);
+
+    // a pinned knight can never stay on the pin line
+    Bitboard knights = m_pieces[get_player_piece(player, wN)] & ~pinned;
+    while (knights) {
+        int square = pop_lsb(knights);
+        add_moves(out, square, knight_attacks(square) & target);
+    }
+
+    Bitboard bishops = m_pieces[get_player_piece(player, wB)] | m_pieces[get_player_piece(player, wQ)];
+    while (bishops) {
+        int square = pop_lsb(bishops);
+        Bitboard attacks = bishop_attacks(square, occupied) & target;
+        if (pinned & square_bb(square)) {
+            attacks &= line_bb(king_square, square);
         }
-        else if (move.get_end_pos()[0] == row && move.get_end_pos()[1] == col) {
-            return true;
+        add_moves(out, square, attacks);
+    }
+
+    Bitboard rooks = m_pieces[get_player_piece(player, wR)] | m_pieces[get_player_piece(player, wQ)];
+    while (rooks) {
+        int square = pop_lsb(rooks);
+        Bitboard attacks = rook_attacks(square, occupied) & target;
+        if (pinned & square_bb(square)) {
+            attacks &= line_bb(king_square, square);
         }
+        add_moves(out, square, attacks);
     }
-    return false;
+
+    add_pawn_moves(out, pawn_target, pinned, ai_legal_moves, gen_type);
 }
 
-vector<Move> Position::generate_legal_moves(const bool ai_legal_moves) const {
-    int king = m_movingturn == WHITE ? wK : bK;
+void Position::add_pawn_moves(MoveList& out, Bitboard target, Bitboard pinned, const bool ai_legal_moves, const int gen_type) const {
     int player = m_movingturn;
-    int opponent = m_movingturn == WHITE ? BLACK : WHITE;
-    std::vector<Move> raw_moves;
-    std::vector<Move> castling_moves = get_castlings(player);
-    raw_moves = get_all_raw_moves(player);
-    raw_moves.insert(raw_moves.end(), castling_moves.begin(), castling_moves.end());
-    std::vector<Move> legal_moves;
-    std::array<int, 4> white_promotables = {wQ, wR, wB, wN};
-    std::array<int, 4> black_promotables = {bQ, bR, bB, bN};
-    for(Move& raw_move: raw_moves) {
-        Position test_pos = *this;
-
-        test_pos.move(raw_move);
-        int row, col;
-        test_pos.get_chess_piece(king, row, col);
-        if (!test_pos.is_square_threatened(row, col, opponent)) {
-            if (ai_legal_moves && test_pos.can_promote(raw_move)) {
-                for (int i = 0; i < 4; i++) {
-                    if (test_pos.get_moving_player() == WHITE) {
-                        raw_move.set_promotable(white_promotables[i]);
-                    } else {
-                        raw_move.set_promotable(black_promotables[i]);
-                    }
-                    legal_moves.push_back(raw_move);
-                }
-            } else {
-                legal_moves.push_back(raw_move);
+    int opponent = player == WHITE ? BLACK : WHITE;
+    int king_square = m_king_square[player];
+    int forward = player == WHITE ? -8 : 8;
+    int start_row = player == WHITE ? 6 : 1;
+    int promotion_row = player == WHITE ? 0 : 7;
+    Bitboard empty = ~get_occupied();
+
+    Bitboard pawns = m_pieces[get_player_piece(player, wP)];
+    while (pawns) {
+        int square = pop_lsb(pawns);
+        Bitboard allowed = target;
+        if (pinned & square_bb(square)) {
+            allowed &= line_bb(king_square, square);
+        }
+        int push = square + forward;
+        // promotions are generated together with captures
+        bool push_allowed = square_row(push) == promotion_row ? gen_type != QUIETS : gen_type != CAPTURES;
+        if ((empty & square_bb(push)) && push_allowed) {
+            if (allowed & square_bb(push)) {
+                add_pawn_move(out, square, push, ai_legal_moves);
+            }
+            int double_push = push + forward;
+            if (square_row(square) == start_row && (empty & allowed & square_bb(double_push))) {
+                out.push_back(Move(square, double_push));
+            }
+        }
+        if (gen_type != QUIETS) {
+            Bitboard captures = pawn_attacks(player, square) & m_occupancy[opponent] & allowed;
+            while (captures) {
+                add_pawn_move(out, square, pop_lsb(captures), ai_legal_moves);
             }
         }
-        test_pos.end_turn();
     }
 
-    return legal_moves;
+    int en_passant_col = m_en_passant_col[opponent];
+    if (en_passant_col == -1 || gen_type == QUIETS) {
+        return;
+    }
+    int captured = make_square(player == WHITE ? 3 : 4, en_passant_col);
+    int destination = captured + forward;
+    Bitboard capturers = pawn_attacks(opponent, destination) & m_pieces[get_player_piece(player, wP)];
+    while (capturers) {
+        int square = pop_lsb(capturers);
+        // Two pawns leave the board line at once, so instead of pin tests
+        // look at the king from the resulting occupancy.
+        Bitboard occupied = (get_occupied() ^ square_bb(square) ^ square_bb(captured)) | square_bb(destination);
+        Bitboard attackers = attackers_to(king_square, occupied) & m_occupancy[opponent] & ~square_bb(captured);
+        if (!attackers) {
+            out.push_back(Move(square, destination, Move::EN_PASSANT));
+        }
+    }
 }
 
-float Position::score_end_result(const int p_depth) const {
-    if (m_movingturn == WHITE) {
-        int row, col;
-        get_chess_piece(wK, row, col);
+void Position::add_pawn_move(MoveList& out, int from, int to, const bool ai_legal_moves) const {
+    int promotion_row = m_movingturn == WHITE ? 0 : 7;
+    if (!ai_legal_moves || square_row(to) != promotion_row) {
+        out.push_back(Move(from, to));
+        return;
+    }
+    const int promotables[4] = {wQ, wR, wB, wN};
+    for (int i = 0; i < 4; i++) {
+        Move move = Move(from, to);
+        move.set_promotable(get_player_piece(m_movingturn, promotables[i]));
+        out.push_back(move);
+    }
+}
 
-        if (is_square_threatened(row, col, BLACK)) {
-            return -100000 - p_depth;
+void Position::add_king_moves(MoveList& out, Bitboard target) const {
+    int opponent = m_movingturn == WHITE ? BLACK : WHITE;
+    int king_square = m_king_square[m_movingturn];
+    // the king is lifted off so it can't hide behind itself on a slider's ray
+    Bitboard occupied = get_occupied() ^ square_bb(king_square);
+    Bitboard targets = king_attacks(king_square) & target;
+    while (targets) {
+        int square = pop_lsb(targets);
+        if (!(attackers_to(square, occupied) & m_occupancy[opponent])) {
+            out.push_back(Move(king_square, square));
+        }
+    }
+}
+
+void Position::add_moves(MoveList& out, int from, Bitboard targets) const {
+    while (targets) {
+        out.push_back(Move(from, pop_lsb(targets)));
+    }
+}
+
+bool Position::is_legal(const Move& p_move) const {
+    int player = m_movingturn;
+    int opponent = player == WHITE ? BLACK : WHITE;
+    int from = p_move.get_start_square();
+    int to = p_move.get_end_square();
+    int chess_piece = m_squares[from];
+    if (p_move.is_null() || chess_piece == NA || get_chess_piece_color(chess_piece) != player || (m_occupancy[player] & square_bb(to))) {
+        return false;
+    }
+
+    // rare move types are simply looked up from the generator
+    if (p_move.get_type() == Move::CASTLING || p_move.get_type() == Move::EN_PASSANT) {
+        MoveList moves;
+        generate_legal_moves(moves, true, p_move.get_type() == Move::CASTLING ? QUIETS : CAPTURES);
+        for (const Move& move : moves) {
+            if (move == p_move) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Bitboard occupied = get_occupied();
+    Bitboard to_bb = square_bb(to);
+    if (chess_piece == get_player_piece(player, wP)) {
+        int forward = player == WHITE ? -8 : 8;
+        int promotion_row = player == WHITE ? 0 : 7;
+        if ((square_row(to) == promotion_row) != (p_move.get_type() == Move::PROMOTION)) {
+            return false;
+        }
+        bool capture = pawn_attacks(player, from) & m_occupancy[opponent] & to_bb;
+        bool push = to == from + forward && !(occupied & to_bb);
+        bool double_push = to == from + 2 * forward && square_row(from) == (player == WHITE ? 6 : 1)
+                        && !(occupied & (square_bb(from + forward) | to_bb));
+        if (!capture && !push && !double_push) {
+            return false;
         }
     } else {
-        int row, col;
-        get_chess_piece(bK, row, col);
+        if (p_move.get_type() == Move::PROMOTION) {
+            return false;
+        }
+        Bitboard attacks = 0;
+        switch (chess_piece) {
+        case wR: case bR: attacks = rook_attacks(from, occupied); break;
+        case wB: case bB: attacks = bishop_attacks(from, occupied); break;
+        case wQ: case bQ: attacks = queen_attacks(from, occupied); break;
+        case wN: case bN: attacks = knight_attacks(from); break;
+        case wK: case bK: attacks = king_attacks(from); break;
+        }
+        if (!(attacks & to_bb)) {
+            return false;
+        }
+    }
+
+    int king_square = m_king_square[player];
+    if (from == king_square) {
+        return !(attackers_to(to, occupied ^ square_bb(from)) & m_occupancy[opponent]);
+    }
+    Bitboard checkers = attackers_to(king_square, occupied) & m_occupancy[opponent];
+    if (checkers) {
+        if (popcount(checkers) > 1 || !((checkers | between_bb(king_square, lsb(checkers))) & to_bb)) {
+            return false;
+        }
+    }
+    if (get_pinned(player, king_square) & square_bb(from)) {
+        return line_bb(king_square, from) & to_bb;
+    }
+    return true;
+}
+
+bool Position::is_capture(const Move& p_move) const {
+    return m_squares[p_move.get_end_square()] != NA || p_move.get_type() == Move::EN_PASSANT;
+}
+
+float Position::see(const Move& p_move) const {
+    // absolute values of material(), indexed by chess piece
+    static const float values[13] = {
+        5.0, 3.0, 3.0, 9.0, 90, 1.0,
+        5.0, 3.0, 3.0, 9.0, 90, 1.0,
+        0.0
+    };
+    int from = p_move.get_start_square();
+    int to = p_move.get_end_square();
+    float gain[32];
+    int depth = 0;
+    gain[0] = p_move.get_type() == Move::EN_PASSANT ? 1.0f : values[m_squares[to]];
+
+    Bitboard occupied = get_occupied();
+    Bitboard rooks = m_pieces[wR] | m_pieces[bR] | m_pieces[wQ] | m_pieces[bQ];
+    Bitboard bishops = m_pieces[wB] | m_pieces[bB] | m_pieces[wQ] | m_pieces[bQ];
+    Bitboard attackers = attackers_to(to, occupied);
+    Bitboard from_bb = square_bb(from);
+    int attacker = m_squares[from];
+    int side = get_chess_piece_color(attacker);
 
-        if (is_square_threatened(row, col, WHITE)) {
-            return 100000 + p_depth;
+    // Both sides keep capturing on the square with their least valuable
+    // attacker, gain[d] is the balance if the exchange stops after capture d.
+    while (from_bb && depth < 31) {
+        depth++;
+        gain[depth] = values[attacker] - gain[depth - 1];
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) {
+            break;
+        }
+        attackers ^= from_bb;
+        occupied ^= from_bb;
+        // sliders behind the piece that just captured join in
+        attackers |= ((rook_attacks(to, occupied) & rooks) | (bishop_attacks(to, occupied) & bishops)) & occupied;
+        side = side == WHITE ? BLACK : WHITE;
+
+        from_bb = 0;
+        const int order[6] = {wP, wN, wB, wR, wQ, wK};
+        for (int i = 0; i < 6; i++) {
+            int chess_piece = get_player_piece(side, order[i]);
+            Bitboard candidates = attackers & m_pieces[chess_piece];
+            if (candidates) {
+                from_bb = candidates & (~candidates + 1);
+                attacker = chess_piece;
+                break;
+            }
         }
     }
+    while (--depth) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    }
+    return gain[0];
+}
+
+float Position::score_end_result(const int p_depth) const {
+    if (is_in_check(m_movingturn)) {
+        return m_movingturn == WHITE ? -MATE_SCORE - p_depth : MATE_SCORE + p_depth;
+    }
     return 0;
 }
 float Position::evaluate() const {
@@ -151,18 +554,19 @@ float Position::evaluate() const {
 }
 
 float Position::material() const {
-    static map<int, float> piece_values = {
-        {wP, 1.0},{wN, 3.0}, {wB, 3.0}, {wR, 5.0}, {wQ, 9.0}, {wK, 90},
-        {bP, -1.0},{bN, -3.0}, {bB, -3.0}, {bR, -5.0}, {bQ, -9.0},{bK, -90},
-        {NA, 0.0}
+    // indexed by chess piece
+    static const float piece_values[13] = {
+        5.0, 3.0, 3.0, 9.0, 90, 1.0,
+        -5.0, -3.0, -3.0, -9.0, -90, -1.0,
+        0.0
     };
 
     float result = 0;
-    for (int row = 0; row < 8; ++row) {
-        for (int col = 0; col < 8; ++col) {
-            int piece = m_board[row][col];
+    for (int piece = wR; piece < NA; ++piece) {
+        for (int i = 0; i < m_piece_count[piece]; ++i) {
+            int square = m_piece_list[piece][i];
             float piece_value  = piece_values[piece];
-            float square_score = get_square_score({row, col}, piece);
+            float square_score = get_square_score({square_row(square), square_col(square)}, piece);
             result += piece_value + square_score;
         }
     }
@@ -170,14 +574,17 @@ float Position::material() const {
 }
 
 float Position::mobility() const {
-    vector<Move> white_moves = get_all_raw_moves(WHITE); 
-    vector<Move> black_moves = get_all_raw_moves(BLACK);
+    MoveList white_moves;
+    MoveList black_moves;
+    get_all_raw_moves(WHITE, white_moves);
+    get_all_raw_moves(BLACK, black_moves);
 
     return (float)white_moves.size() - (float)black_moves.size();
 }
 
 MinmaxValue Position::minmax(int depth) {
-    vector<Move> legal_moves = this->generate_legal_moves(true);
+    MoveList legal_moves;
+    this->generate_legal_moves(legal_moves, true);
 
     if (legal_moves.size() == 0) {
         return MinmaxValue(this->score_end_result(depth), Move());
@@ -191,10 +598,9 @@ MinmaxValue Position::minmax(int depth) {
     float best_value = this->get_moving_player() == WHITE ? numeric_limits<float>::lowest() : numeric_limits<float>::max();
     Move best_move;
     for(Move &move : legal_moves) {
-        Position new_pos = *this;
-        new_pos.move(move);
-        new_pos.end_turn();
-        MinmaxValue minmaxval = new_pos.minmax(depth -1);
+        make_move(move);
+        MinmaxValue minmaxval = minmax(depth -1);
+        unmake_move();
         if (this->get_moving_player() == WHITE && minmaxval.value > best_value) {
             best_value = minmaxval.value;
             best_move = move;
@@ -206,174 +612,85 @@ MinmaxValue Position::minmax(int depth) {
     return MinmaxValue(best_value, best_move);
 }
 
-MinmaxValue Position::threaded_alpha_beta(std::vector<Move> p_legal_moves, int depth, MinmaxValue alpha, MinmaxValue beta) {
-    float best_value = this->get_moving_player() == WHITE ? numeric_limits<float>::lowest() : numeric_limits<float>::max();
-    bool maximizingPlayer = this->get_moving_player() == WHITE ? true : false;
-    Move best_move;
-    for (Move& move : p_legal_moves) {
-        Position new_pos = *this;
-        new_pos.move(move);
-        if (new_pos.can_promote(move)) {
-            new_pos.promote(move.get_end_pos(), move.get_promotable());
-        }
-        new_pos.end_turn();
-        MinmaxValue current_move = new_pos.minmax_alphabeta(depth - 1, alpha, beta, false);
-        if (maximizingPlayer) {
-            if (current_move.value > best_value) {
-                best_value = current_move.value;
-                best_move = move;
-            }
-            if (current_move.value > alpha.value) {
-                alpha.value = current_move.value;
-                alpha.move = move;
-            }
-        } else {
-            if (current_move.value < best_value) {
-                best_value = current_move.value;
-                best_move = move;
-            }
-            if (current_move.value < beta.value) {
-                beta.value = current_move.value;
-                beta.move = move;
-            }
-        }
-        if (beta.value <= alpha.value) {
-            break;
-        }
-    }
-    return MinmaxValue(best_value, best_move);
+MinmaxValue Position::minmax_alphabeta(int depth, MinmaxValue alpha, MinmaxValue beta) {
+    Search search(*this);
+    return search.alpha_beta(depth, alpha, beta);
 }
 
-std::vector<std::future<MinmaxValue>> threads;
-
-MinmaxValue Position::minmax_alphabeta(int depth, MinmaxValue alpha, MinmaxValue beta, const bool threaded) {
-    vector<Move> legal_moves = this->generate_legal_moves(true);
-    if (legal_moves.size() == 0) {
-        return MinmaxValue(this->score_end_result(depth), Move());
-    }
-    if (depth == 0) {
-        float value = this->evaluate();
-        return MinmaxValue(value, Move());
-    }
-
-    bool maximizingPlayer = this->get_moving_player() == WHITE ? true : false;
-    float best_value = this->get_moving_player() == WHITE ? numeric_limits<float>::lowest() : numeric_limits<float>::max();
-    MinmaxValue best_move;
-    if (threaded) {
-        if (threads.size() == 0) {
-            // we want n-2 due to in the main function we are using one thread already + main thread
-            unsigned int nthreads = std::thread::hardware_concurrency() - 2;
-            threads.resize(nthreads);
-        }
-        int split_size = std::floor(legal_moves.size() / threads.size());
-        std::vector<std::vector<Move>> split_moves;
-        split_moves.resize(threads.size()); 
-        int current_thread = split_size != 0 ? -1 : 0;
-        for (int i = 0; i < legal_moves.size(); ++i) {
-            if (split_size > 0) {
-                if (current_thread != threads.size() - 1 && i % split_size == 0) {
-                    current_thread += 1;
-                }
-            }
-            split_moves[current_thread].push_back(legal_moves[i]);
-        }
-        std::vector<MinmaxValue> results;
-        results.resize(threads.size());
-        for (int i = 0; i < threads.size(); i++) {
-            threads[i] = std::async(&Position::threaded_alpha_beta, this, split_moves[i], depth,alpha, beta);
-            if (threads[i].valid()) {
-                threads[i].wait();
-                results[i] = threads[i].get();
-            }
-        }
-        std::vector<float> values;
-        for (int i = 0; i < results.size(); i++) {
-            values.push_back(results[i].value);
-        }
-        std::vector<float>::iterator result = maximizingPlayer ? std::max_element(values.begin(), values.end()) : std::min_element(values.begin(), values.end());
-        int index = std::distance(values.begin(), result);
-        best_move = results[index];
-    } else {
-        best_move = threaded_alpha_beta(legal_moves, depth, alpha, beta);
-    }
-
-    return best_move;
-}
 
+// Castling rights that survive a move touching the square, so moving a king
+// or rook, or capturing a rook, clears the matching rights.
+static const std::array<int, SQUARE_COUNT> CASTLING_RIGHTS_MASK = [] {
+    std::array<int, SQUARE_COUNT> mask;
+    mask.fill(ALL_CASTLINGS);
+    mask[make_square(0, 0)] &= ~BLACK_LONG_CASTLING;
+    mask[make_square(0, 7)] &= ~BLACK_SHORT_CASTLING;
+    mask[make_square(0, 4)] &= ~(BLACK_LONG_CASTLING | BLACK_SHORT_CASTLING);
+    mask[make_square(7, 0)] &= ~WHITE_LONG_CASTLING;
+    mask[make_square(7, 7)] &= ~WHITE_SHORT_CASTLING;
+    mask[make_square(7, 4)] &= ~(WHITE_LONG_CASTLING | WHITE_SHORT_CASTLING);
+    return mask;
+}();
 
 void Position::move(const Move& p_move) {
-    int chess_piece = m_board[p_move.get_start_pos()[0]][p_move.get_start_pos()[1]];
-    m_board[p_move.get_start_pos()[0]][p_move.get_start_pos()[1]] = NA;
+    int start_square = p_move.get_start_square();
+    int end_square = p_move.get_end_square();
+    int chess_piece = m_squares[start_square];
+    remove_piece(start_square);
     // Castling
-    if (chess_piece == wK && p_move.get_start_pos()[0] == 7 && p_move.get_start_pos()[1] == 4 && p_move.get_end_pos()[0] == 7 && p_move.get_end_pos()[1] == 6)
+    if (chess_piece == wK && start_square == make_square(7, 4) && end_square == make_square(7, 6))
     {
-        m_board[7][7] = NA;
-        m_board[7][5] = wR;
+        remove_piece(make_square(7, 7));
+        put_piece(wR, make_square(7, 5));
     }
-    else if (chess_piece == wK && p_move.get_start_pos()[0] == 7 && p_move.get_start_pos()[1] == 4 && p_move.get_end_pos()[0] == 7 && p_move.get_end_pos()[1] == 2)
+    else if (chess_piece == wK && start_square == make_square(7, 4) && end_square == make_square(7, 2))
     {
-        m_board[7][0] = NA;
-        m_board[7][3] = wR;
+        remove_piece(make_square(7, 0));
+        put_piece(wR, make_square(7, 3));
     }
-    else if (chess_piece == bK && p_move.get_start_pos()[0] == 0 && p_move.get_start_pos()[1] == 4 && p_move.get_end_pos()[0] == 0 && p_move.get_end_pos()[1] == 6)
+    else if (chess_piece == bK && start_square == make_square(0, 4) && end_square == make_square(0, 6))
     {
-        m_board[0][7] = NA;
-        m_board[0][5] = bR;
+        remove_piece(make_square(0, 7));
+        put_piece(bR, make_square(0, 5));
     }
-    else if (chess_piece == bK && p_move.get_start_pos()[0] == 0 && p_move.get_start_pos()[1] == 4 && p_move.get_end_pos()[0] == 0 && p_move.get_end_pos()[1] == 2)
+    else if (chess_piece == bK && start_square == make_square(0, 4) && end_square == make_square(0, 2))
     {
-        m_board[0][0] = NA;
-        m_board[0][3] = bR;
+        remove_piece(make_square(0, 0));
+        put_piece(bR, make_square(0, 3));
     }
 
-    if (chess_piece == bK)
-    {
-        m_black_long_castling_allowed = false;
-        m_black_short_castling_allowed = false;
-    }
-    else if (chess_piece == wK)
-    {
-        m_white_long_castling_allowed = false;
-        m_white_short_castling_allowed = false;
-    }
-    else if (chess_piece == bR && p_move.get_start_pos()[0] == 0 && p_move.get_start_pos()[1] == 0 || p_move.get_end_pos()[0] == 0 && p_move.get_end_pos()[1] == 0)
-    {
-        m_black_long_castling_allowed = false;
-    }
-    else if (chess_piece == bR && p_move.get_start_pos()[0] == 0 && p_move.get_start_pos()[1] == 7 || p_move.get_end_pos()[0] == 0 && p_move.get_end_pos()[1] == 7)
-    {
-        m_black_short_castling_allowed = false;
-    }
-    else if (chess_piece == wR && p_move.get_start_pos()[0] == 7 && p_move.get_start_pos()[1] == 0 || p_move.get_end_pos()[0] == 7 && p_move.get_end_pos()[1] == 0)
-    {
-        m_white_long_castling_allowed = false;
-    }
-    else if (chess_piece == wR && p_move.get_start_pos()[0] == 7 && p_move.get_start_pos()[1] == 7 || p_move.get_end_pos()[0] == 7 && p_move.get_end_pos()[1] == 7)
-    {
-        m_white_short_castling_allowed = false;
-    }
+    m_key ^= ZOBRIST.castling[m_castling_rights];
+    m_castling_rights &= CASTLING_RIGHTS_MASK[start_square] & CASTLING_RIGHTS_MASK[end_square];
+    m_key ^= ZOBRIST.castling[m_castling_rights];
 
     //en passant eating
-    if (p_move.get_end_pos()[1] == m_en_passant_col[WHITE] && p_move.get_end_pos()[0] == 5)
+    if (chess_piece == bP && p_move.get_end_pos()[1] == m_en_passant_col[WHITE] && p_move.get_end_pos()[0] == 5)
     {
-        m_board[4][m_en_passant_col[WHITE]] = NA;
+        remove_piece(make_square(4, m_en_passant_col[WHITE]));
     }
-    else if (p_move.get_end_pos()[1] == m_en_passant_col[BLACK] && p_move.get_end_pos()[0] == 2)
+    else if (chess_piece == wP && p_move.get_end_pos()[1] == m_en_passant_col[BLACK] && p_move.get_end_pos()[0] == 2)
     {
-        m_board[3][m_en_passant_col[BLACK]] = NA;
+        remove_piece(make_square(3, m_en_passant_col[BLACK]));
     }
 
     //en passant check
+    for (int player = WHITE; player <= BLACK; player++) {
+        if (m_en_passant_col[player] != -1) {
+            m_key ^= ZOBRIST.en_passant[m_en_passant_col[player]];
+        }
+    }
     int moves = std::abs(p_move.get_end_pos()[0] - p_move.get_start_pos()[0]);
     if (chess_piece == wP && moves == 2)
     {
         m_en_passant_col[WHITE] = p_move.get_end_pos()[1];
         m_en_passant_col[BLACK] = -1;
+        m_key ^= ZOBRIST.en_passant[m_en_passant_col[WHITE]];
     }
     else if (chess_piece == bP && moves == 2)
     {
         m_en_passant_col[BLACK] = p_move.get_end_pos()[1];
         m_en_passant_col[WHITE] = -1;
+        m_key ^= ZOBRIST.en_passant[m_en_passant_col[BLACK]];
     }
     else
     {
@@ -381,7 +698,84 @@ void Position::move(const Move& p_move) {
         m_en_passant_col[WHITE] = -1;
     }
 
-    m_board[p_move.get_end_pos()[0]][p_move.get_end_pos()[1]] = chess_piece;
+    remove_piece(end_square);
+    put_piece(chess_piece, end_square);
+}
+
+void Position::make_move(const Move& p_move) {
+    int start_square = p_move.get_start_square();
+    int end_square = p_move.get_end_square();
+    UndoInfo& undo = m_undo_stack[m_undo_count++];
+    undo.move = p_move;
+    undo.moved_piece = m_squares[start_square];
+    undo.captured_piece = m_squares[end_square];
+    undo.captured_square = end_square;
+    undo.castling_rights = m_castling_rights;
+    undo.en_passant_col[WHITE] = m_en_passant_col[WHITE];
+    undo.en_passant_col[BLACK] = m_en_passant_col[BLACK];
+    undo.key = m_key;
+    // en passant takes the pawn beside the destination square
+    if (undo.moved_piece == bP && p_move.get_end_pos()[1] == m_en_passant_col[WHITE] && p_move.get_end_pos()[0] == 5) {
+        undo.captured_square = make_square(4, m_en_passant_col[WHITE]);
+        undo.captured_piece = wP;
+    } else if (undo.moved_piece == wP && p_move.get_end_pos()[1] == m_en_passant_col[BLACK] && p_move.get_end_pos()[0] == 2) {
+        undo.captured_square = make_square(3, m_en_passant_col[BLACK]);
+        undo.captured_piece = bP;
+    }
+
+    move(p_move);
+    if (p_move.get_promotable() != NA && can_promote(p_move)) {
+        promote(p_move.get_end_pos(), p_move.get_promotable());
+    }
+    end_turn();
+}
+
+void Position::unmake_move() {
+    const UndoInfo& undo = m_undo_stack[--m_undo_count];
+    int start_square = undo.move.get_start_square();
+    int end_square = undo.move.get_end_square();
+    end_turn();
+
+    remove_piece(end_square);
+    put_piece(undo.moved_piece, start_square);
+    put_piece(undo.captured_piece, undo.captured_square);
+
+    // put the castled rook back to its corner
+    if ((undo.moved_piece == wK || undo.moved_piece == bK) && std::abs(end_square - start_square) == 2) {
+        int row = square_row(start_square);
+        bool short_castling = end_square > start_square;
+        remove_piece(make_square(row, short_castling ? 5 : 3));
+        put_piece(undo.moved_piece == wK ? wR : bR, make_square(row, short_castling ? 7 : 0));
+    }
+
+    m_castling_rights = undo.castling_rights;
+    m_en_passant_col[WHITE] = undo.en_passant_col[WHITE];
+    m_en_passant_col[BLACK] = undo.en_passant_col[BLACK];
+    m_key = undo.key;
+}
+
+void Position::make_null_move() {
+    UndoInfo& undo = m_undo_stack[m_undo_count++];
+    undo.move = Move();
+    undo.en_passant_col[WHITE] = m_en_passant_col[WHITE];
+    undo.en_passant_col[BLACK] = m_en_passant_col[BLACK];
+    undo.key = m_key;
+    // the pawn that could be taken en passant stays safe after a pass
+    for (int player = WHITE; player <= BLACK; player++) {
+        if (m_en_passant_col[player] != -1) {
+            m_key ^= ZOBRIST.en_passant[m_en_passant_col[player]];
+            m_en_passant_col[player] = -1;
+        }
+    }
+    end_turn();
+}
+
+void Position::unmake_null_move() {
+    const UndoInfo& undo = m_undo_stack[--m_undo_count];
+    end_turn();
+    m_en_passant_col[WHITE] = undo.en_passant_col[WHITE];
+    m_en_passant_col[BLACK] = undo.en_passant_col[BLACK];
+    m_key = undo.key;
 }
 
 void Position::end_turn() {
@@ -391,24 +785,29 @@ void Position::end_turn() {
     else if (m_movingturn == BLACK) {
         m_movingturn = WHITE;
     }
+    m_key ^= ZOBRIST.black_to_move;
+    // debug builds verify the incremental updates once per move
+    assert(m_key == compute_key());
 }
 
 bool Position::can_promote(const Move& p_move) {
-    int chess_piece = m_board[p_move.get_end_pos()[0]][p_move.get_end_pos()[1]];
+    int chess_piece = get_piece(p_move.get_end_pos()[0], p_move.get_end_pos()[1]);
     int player = get_chess_piece_color(chess_piece);
     return is_promotable(chess_piece, p_move.get_end_pos()[0]);
 }
 
 void Position::promote(std::array<int, 2> end_pos, int chess_piece) {
-    m_board[end_pos[0]][end_pos[1]] = chess_piece;
+    int square = make_square(end_pos[0], end_pos[1]);
+    remove_piece(square);
+    put_piece(chess_piece, square);
 }
 
-bool Position::check_collision(int row_now, int col_now, int row, int col, int player,vector<Move>& out) const {
-    int chess_piece = m_board[row][col];
+bool Position::check_collision(int row_now, int col_now, int row, int col, int player,MoveList& out) const {
+    int chess_piece = get_piece(row, col);
     bool is_pawn = chess_piece == wP || chess_piece == bP;
     bool can_hit = !(is_pawn && col_now == col);
     // Please god don't touch this. It works perfectly trust me bro.
-    if (m_board[row_now][col_now]==NA) {
+    if (get_piece(row_now, col_now)==NA) {
         if (is_pawn) {
             if (!can_hit) {
                out.push_back(Move({row, col}, {row_now, col_now})); 
@@ -418,7 +817,7 @@ bool Position::check_collision(int row_now, int col_now, int row, int col, int p
         }
         return true;
     }
-    if (get_chess_piece_color(m_board[row_now][col_now]) == player) {
+    if (get_chess_piece_color(get_piece(row_now, col_now)) == player) {
         return false;
     }
     if (can_hit) {
@@ -427,76 +826,49 @@ bool Position::check_collision(int row_now, int col_now, int row, int col, int p
     return false;
 }
 
-vector<Move> Position::get_rook_raw_move(int row, int col, int player) const {
-    vector<Move> out;
-    vector<Move> up = get_directional_raw_move({row, col}, {0, -1}, player);
-    vector<Move> down = get_directional_raw_move({row, col}, {0, 1}, player);
-    vector<Move> left = get_directional_raw_move({row, col}, {-1, 0}, player);
-    vector<Move> right = get_directional_raw_move({row, col}, {1, 0}, player);
-    out.insert(out.end(), up.begin(), up.end());
-    out.insert(out.end(), down.begin(), down.end());
-    out.insert(out.end(), left.begin(), left.end());
-    out.insert(out.end(), right.begin(), right.end());
-    return out;
-}
-
-vector<Move> Position::get_bishop_raw_move(int row, int col, int player) const {
-    vector<Move> out;
-    vector<Move> up_right = get_directional_raw_move({row, col}, {1, -1}, player);
-    vector<Move> up_left = get_directional_raw_move({row, col}, {-1, -1}, player);
-    vector<Move> down_left = get_directional_raw_move({row, col}, {-1, 1}, player);
-    vector<Move> down_right = get_directional_raw_move({row, col}, {1, 1}, player);
-    out.insert(out.end(), up_right.begin(), up_right.end());
-    out.insert(out.end(), up_left.begin(), up_left.end());
-    out.insert(out.end(), down_left.begin(), down_left.end());
-    out.insert(out.end(), down_right.begin(), down_right.end());
-    return out;
-}
-
-vector<Move> Position::get_queen_raw_move(int row, int col, int player) const {
-    vector<Move> out; 
-    vector<Move> rook = get_bishop_raw_move(row, col, player);
-    vector<Move> tower = get_rook_raw_move(row, col, player);
-    out.insert(out.end(), rook.begin(), rook.end());
-    out.insert(out.end(), tower.begin(), tower.end());
-    return out;
-}
-
-vector<Move> Position::get_knight_raw_move(int row, int col, int player) const {
-    vector<Move> out;
-    vector<Move> up_right = get_directional_raw_move({row, col}, {1, -2}, player);
-    vector<Move> right_up = get_directional_raw_move({row, col}, {2, -1}, player);
-    vector<Move> right_down = get_directional_raw_move({row, col}, {2, 1}, player);
-    vector<Move> down_right = get_directional_raw_move({row, col}, {1, 2}, player);
-    vector<Move> down_left = get_directional_raw_move({row, col}, {-1, 2}, player);
-    vector<Move> left_down = get_directional_raw_move({row, col}, {-2, 1}, player);
-    vector<Move> left_up = get_directional_raw_move({row, col}, {-2, -1}, player);
-    vector<Move> up_left = get_directional_raw_move({row, col}, {-1, -2}, player);
-    out.insert(out.end(), up_right.begin(), up_right.end());
-    out.insert(out.end(), right_up.begin(), right_up.end());
-    out.insert(out.end(), right_down.begin(), right_down.end());
-    out.insert(out.end(), down_right.begin(), down_right.end());
-    out.insert(out.end(), down_left.begin(), down_left.end());
-    out.insert(out.end(), left_down.begin(), left_down.end());
-    out.insert(out.end(), left_up.begin(), left_up.end());
-    out.insert(out.end(), up_left.begin(), up_left.end());
-    return out;
-}
-
-vector<Move> Position::get_king_raw_move(int row, int col, int player) const {
-    return get_queen_raw_move(row, col, player);
-}
-
-vector<Move> Position::get_directional_raw_move(std::array<int, 2> position, std::array<int, 2> direction, int player) const {
-    vector<Move> out;
+void Position::get_slider_raw_move(int row, int col, Bitboard attacks, int player, MoveList& out) const {
+    attacks &= ~m_occupancy[player];
+    while (attacks) {
+        int square = pop_lsb(attacks);
+        out.push_back(Move(make_square(row, col), square));
+    }
+}
+
+void Position::get_rook_raw_move(int row, int col, int player, MoveList& out) const {
+    get_slider_raw_move(row, col, rook_attacks(make_square(row, col), get_occupied()), player, out);
+}
+
+void Position::get_bishop_raw_move(int row, int col, int player, MoveList& out) const {
+    get_slider_raw_move(row, col, bishop_attacks(make_square(row, col), get_occupied()), player, out);
+}
+
+void Position::get_queen_raw_move(int row, int col, int player, MoveList& out) const {
+    get_slider_raw_move(row, col, queen_attacks(make_square(row, col), get_occupied()), player, out);
+}
+
+void Position::get_knight_raw_move(int row, int col, int player, MoveList& out) const {
+    const int directions[8][2] = {{1, -2}, {2, -1}, {2, 1}, {1, 2}, {-1, 2}, {-2, 1}, {-2, -1}, {-1, -2}};
+    for (int i = 0; i < 8; i++) {
+        get_directional_raw_move({row, col}, {directions[i][0], directions[i][1]}, player, out);
+    }
+}
+
+void Position::get_king_raw_move(int row, int col, int player, MoveList& out) const {
+    const int directions[8][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}, {1, -1}, {-1, -1}, {-1, 1}, {1, 1}};
+    for (int i = 0; i < 8; i++) {
+        get_directional_raw_move({row, col}, {directions[i][0], directions[i][1]}, player, out);
+    }
+}
+
+void Position::get_directional_raw_move(std::array<int, 2> position, std::array<int, 2> direction, int player, MoveList& out) const {
     int row_now = position[0];
     int col_now = position[1];
     int max_moves = 7;
-    int chess_piece = m_board[position[0]][position[1]];
+    int chess_piece = get_piece(position[0], position[1]);
     int move = 0;
     if (chess_piece == NA) {
         std::cout<<"no chess piece found"<<std::endl;
-        return out;
+        return;
     }
     if (chess_piece == wK || chess_piece == bK || chess_piece == wN || chess_piece == bN ) {
         max_moves = 1;
@@ -513,19 +885,17 @@ vector<Move> Position::get_directional_raw_move(std::array<int, 2> position, std
         }
         break;
     }
-    return out;
 }
 
-vector<Move> Position::get_pawn_raw_move(int row, int col, int player) const {
-    vector<Move> out;
+void Position::get_pawn_raw_move(int row, int col, int player, MoveList& out) const {
     int row_now = row;
     int col_now = col;
     int max_moves = 1;
-    int chess_piece = m_board[row][col];
+    int chess_piece = get_piece(row, col);
     int move = 0;
     if (chess_piece == NA) {
         std::cout<<"no chess piece found"<<std::endl;
-        return out;
+        return;
     }
     if ((chess_piece == bP && row == 1) || (chess_piece == wP && row == 6)) {
         max_moves = 2;
@@ -578,36 +948,32 @@ vector<Move> Position::get_pawn_raw_move(int row, int col, int player) const {
             out.push_back(Move({ row, col }, { 2, m_en_passant_col[BLACK] }));
         }
     }
-
-
-    return out;
 }
 
-vector<Move> Position::get_castlings(int player) const {
-    vector<Move> out;
-    if (player == WHITE)
-    {
-        if (m_white_short_castling_allowed && m_board[7][5] == NA && m_board[7][6] == NA && !is_square_threatened(7, 4, BLACK) && !is_square_threatened(7, 5, BLACK))
-        {
-            out.push_back(Move({7, 4}, {7, 6}));
-        }
-        if (m_white_long_castling_allowed && m_board[7][3] == NA && m_board[7][2] == NA && m_board[7][1] == NA && !is_square_threatened(7, 4, BLACK) && !is_square_threatened(7, 3, BLACK))
-        {
-            out.push_back(Move({7, 4}, {7, 2}));
-        }
+void Position::get_castlings(int player, MoveList& out) const {
+    int opponent = player == WHITE ? BLACK : WHITE;
+    int row = player == WHITE ? 7 : 0;
+    int short_castling = player == WHITE ? WHITE_SHORT_CASTLING : BLACK_SHORT_CASTLING;
+    int long_castling = player == WHITE ? WHITE_LONG_CASTLING : BLACK_LONG_CASTLING;
+    Bitboard occupied = get_occupied();
+    int king_square = make_square(row, 4);
+    if (!(m_castling_rights & (short_castling | long_castling)) || (attackers_to(king_square, occupied) & m_occupancy[opponent])) {
+        return;
     }
-    else
-    {
-        if (m_black_short_castling_allowed && m_board[0][5] == NA && m_board[0][6] == NA && !is_square_threatened(0, 4, WHITE) && !is_square_threatened(0, 5, WHITE))
-        {
-            out.push_back(Move({0, 4}, {0, 6}));
-        }
-        if (m_black_long_castling_allowed && m_board[0][3] == NA && m_board[0][2] == NA && m_board[0][1] == NA && !is_square_threatened(0, 4, WHITE) && !is_square_threatened(0, 3, WHITE))
-        {
-            out.push_back(Move({0, 4}, {0, 2}));
-        }
+
+    // the king may not pass or land on an attacked square
+    if ((m_castling_rights & short_castling)
+        && !(occupied & between_bb(king_square, make_square(row, 7)))
+        && !(attackers_to(make_square(row, 5), occupied) & m_occupancy[opponent])
+        && !(attackers_to(make_square(row, 6), occupied) & m_occupancy[opponent])) {
+        out.push_back(Move(king_square, make_square(row, 6), Move::CASTLING));
+    }
+    if ((m_castling_rights & long_castling)
+        && !(occupied & between_bb(king_square, make_square(row, 0)))
+        && !(attackers_to(make_square(row, 3), occupied) & m_occupancy[opponent])
+        && !(attackers_to(make_square(row, 2), occupied) & m_occupancy[opponent])) {
+        out.push_back(Move(king_square, make_square(row, 2), Move::CASTLING));
     }
-    return out;
 }
 
 void Position::render_board() {
@@ -623,7 +989,7 @@ void Position::render_board() {
             
         }
         for (int col= 0; col < board_size; col ++) {
-            const std::string piece = chess_piece_to_string(m_board[row][col]);
+            const std::string piece = chess_piece_to_string(get_piece(row, col));
             if (col == board_size) {
                 map += "|";
             }
@@ -650,7 +1016,7 @@ void Position::render_board() {
     std::cout<< "   A    B    C    D    E    F    G    H"<<std::endl;
 }
 
-void Position::render_legal_moves(const vector<Move>& p_moves) {
+void Position::render_legal_moves(const MoveList& p_moves) {
     std::cout<<"valid moves:"<<std::endl;
     for (int i = 0; i < p_moves.size(); i++) {
         std::cout<<" "<<p_moves[i].get_coords()<<std::endl;
@@ -660,12 +1026,9 @@ void Position::render_legal_moves(const vector<Move>& p_moves) {
 }
 
 int Position::get_winner() {
-    int row, col;
-    get_chess_piece(wK, row, col);
-    if (is_square_threatened(row, col, BLACK))
+    if (is_in_check(WHITE))
         return -1;
-    get_chess_piece(bK, row, col);
-    if (is_square_threatened(row, col, WHITE))
+    if (is_in_check(BLACK))
         return 1;
     return 0;
 }
\ No newline at end of file
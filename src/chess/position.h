@@ -2,9 +2,44 @@
 
 #include "chess.h"
 #include "move.h"
+#include "bitboard.h"
 #include <vector>
 #include <array>
 
+// Which legal moves generate_legal_moves() produces. Promotions count as
+// captures, castlings as quiet moves.
+enum { ALL_MOVES, CAPTURES, QUIETS };
+
+// Castling rights, one bit each.
+enum {
+  WHITE_SHORT_CASTLING = 1,
+  WHITE_LONG_CASTLING = 2,
+  BLACK_SHORT_CASTLING = 4,
+  BLACK_LONG_CASTLING = 8,
+  ALL_CASTLINGS = 15
+};
+
+// Most pieces of one kind a position can have (two plus eight promoted pawns).
+const int MAX_PIECE_COUNT = 10;
+
+// Deepest line of make_move() calls a Position can take back.
+const int MAX_PLY = 128;
+
+// What make_move() needs to remember so unmake_move() can restore the position.
+struct UndoInfo {
+  Move move;
+  int8_t moved_piece;
+  int8_t captured_piece;
+  int8_t captured_square;
+  int8_t castling_rights;
+  int8_t en_passant_col[2];
+  uint64_t key;
+};
+
+// A mate scores MATE_SCORE + the remaining search depth, so faster mates
+// score higher. White's mates are positive, black's negative.
+const float MATE_SCORE = 100000;
+
 struct MinmaxValue {
   float value;
   Move move;
@@ -20,25 +55,57 @@ struct MinmaxValue {
 
 class Position {
 public: 
+  Position();
   void clear();
+  // Sets up the position from a FEN string, false if it can't be parsed.
+  // The move counters are ignored.
+  bool set_fen(const std::string& p_fen);
   void move(const Move& p_move);
+  // move() + promotion + end_turn() that can be taken back with unmake_move().
+  void make_move(const Move& p_move);
+  void unmake_move();
+  // Passes the turn without moving, for null move pruning. Taken back with
+  // unmake_null_move().
+  void make_null_move();
+  void unmake_null_move();
   void end_turn();
   bool can_promote(const Move& p_move);
   void promote(std::array<int, 2> end_pos, int chess_piece);
   void render_board();
-  std::array<std::array<int, 8>, 8> get_board() const { return m_board;}
-  void render_legal_moves(const vector<Move>& p_moves);
-  std::vector<Move> get_all_raw_moves(int player) const;
+  std::array<std::array<int, 8>, 8> get_board() const;
+  int get_piece(int row, int col) const { return m_squares[make_square(row, col)]; }
+  Bitboard get_pieces(int chess_piece) const { return m_pieces[chess_piece]; }
+  Bitboard get_occupancy(int player) const { return m_occupancy[player]; }
+  Bitboard get_occupied() const { return m_occupancy[WHITE] | m_occupancy[BLACK]; }
+  int get_king_square(int player) const { return m_king_square[player]; }
+  // Squares of every chess_piece on the board, in no particular order.
+  int get_piece_count(int chess_piece) const { return m_piece_count[chess_piece]; }
+  const uint8_t* get_piece_list(int chess_piece) const { return m_piece_list[chess_piece]; }
+  // Zobrist key of the position, kept up to date by every board change.
+  uint64_t get_key() const { return m_key; }
+  // Same key computed from scratch.
+  uint64_t compute_key() const;
+  void render_legal_moves(const MoveList& p_moves);
+  void get_all_raw_moves(int player, MoveList& out) const;
   void get_chess_piece(int chess_piece, int& row, int& col) const;
+  // Pieces of both players attacking the square, sliders are blocked by occupied.
+  Bitboard attackers_to(int square, Bitboard occupied) const;
   bool is_square_threatened(int row, int col, int threatening_player) const;
-  vector<Move> get_rook_raw_move(int row, int col, int player) const;
-  vector<Move> get_bishop_raw_move(int row, int col, int player) const;
-  vector<Move> get_queen_raw_move(int row, int col, int player) const;
-  vector<Move> get_knight_raw_move(int row, int col, int player) const;
-  vector<Move> get_king_raw_move(int row, int col, int player) const;
-  vector<Move> get_pawn_raw_move(int row, int col, int player) const;
-  vector<Move> get_castlings(int player) const;
-  vector<Move> generate_legal_moves(const bool ai_legal_moves = false) const;
+  bool is_in_check(int player) const;
+  void get_rook_raw_move(int row, int col, int player, MoveList& out) const;
+  void get_bishop_raw_move(int row, int col, int player, MoveList& out) const;
+  void get_queen_raw_move(int row, int col, int player, MoveList& out) const;
+  void get_knight_raw_move(int row, int col, int player, MoveList& out) const;
+  void get_king_raw_move(int row, int col, int player, MoveList& out) const;
+  void get_pawn_raw_move(int row, int col, int player, MoveList& out) const;
+  void get_castlings(int player, MoveList& out) const;
+  void generate_legal_moves(MoveList& out, const bool ai_legal_moves = false, const int gen_type = ALL_MOVES) const;
+  // Full legality test of a move taken from another position (hash or killer moves).
+  bool is_legal(const Move& p_move) const;
+  bool is_capture(const Move& p_move) const;
+  // Static exchange evaluation: material won by the side making the move
+  // after all captures on its end square, in pawns.
+  float see(const Move& p_move) const;
   int get_moving_player() const {return m_movingturn;}
   int get_winner();
 
@@ -52,37 +119,55 @@ public:
 
   MinmaxValue minmax(int depth);
 
-  MinmaxValue minmax_alphabeta(int depth, MinmaxValue alpha, MinmaxValue beta, const bool threaded = false);
+  // Fixed depth search on one thread, ThreadPool in threads.h is the
+  // engine's entry point.
+  MinmaxValue minmax_alphabeta(int depth, MinmaxValue alpha, MinmaxValue beta);
 
 private:
-  MinmaxValue threaded_alpha_beta(std::vector<Move> p_legal_moves, int depth, MinmaxValue alpha, MinmaxValue beta);
-  vector<Move> get_directional_raw_move(std::array<int, 2> position, std::array<int, 2> direction, int player) const;
-  bool check_collision(int row_now, int col_now, int row, int col,int player,vector<Move>& out) const;
-  // board pieces cols and rows. Example:
+  // Pieces of player that can't leave the line between their king and an enemy slider.
+  Bitboard get_pinned(int player, int king_square) const;
+  // Destination squares allowed for the gen_type, own pieces excluded.
+  Bitboard get_gen_type_target(const int gen_type) const;
+  void generate_evasions(MoveList& out, Bitboard checkers, Bitboard pinned, const bool ai_legal_moves, const int gen_type) const;
+  void add_piece_moves(MoveList& out, Bitboard target, Bitboard pinned, const bool ai_legal_moves, const int gen_type) const;
+  void add_pawn_moves(MoveList& out, Bitboard target, Bitboard pinned, const bool ai_legal_moves, const int gen_type) const;
+  void add_pawn_move(MoveList& out, int from, int to, const bool ai_legal_moves) const;
+  void add_king_moves(MoveList& out, Bitboard target) const;
+  void add_moves(MoveList& out, int from, Bitboard targets) const;
+  void get_slider_raw_move(int row, int col, Bitboard attacks, int player, MoveList& out) const;
+  void get_directional_raw_move(std::array<int, 2> position, std::array<int, 2> direction, int player, MoveList& out) const;
+  bool check_collision(int row_now, int col_now, int row, int col,int player,MoveList& out) const;
+  void put_piece(int chess_piece, int square);
+  void remove_piece(int square);
+  // One bitboard per chess piece (indexed by wR..bP) and one per player.
+  // These are the authoritative board state, get_board() is derived from them.
   //
-  // [0][0] : left upper corner ("a8")
-  // [7][0] : left lower corner ("a1")
-  // [7][7] : right lower corner ("h1")
+  // Squares are indexed as row * 8 + col of get_board():
+  // 0  : left upper corner ("a8")
+  // 56 : left lower corner ("a1")
+  // 63 : right lower corner ("h1")
   //
-  std::array<std::array<int, 8>, 8> m_board = {{
-    {bR, bN, bB, bQ, bK, bB, bN, bR},
-    {bP, bP, bP, bP, bP, bP, bP, bP}, 
-    {NA, NA, NA, NA, NA, NA, NA, NA},
-    {NA, NA, NA, NA, NA, NA, NA, NA},
-    {NA, NA, NA, NA, NA, NA, NA, NA},
-    {NA, NA, NA, NA, NA, NA, NA, NA},
-    {wP, wP, wP, wP, wP, wP, wP, wP},
-    {wR, wN, wB, wQ, wK, wB, wN, wR}, 
-  }};
+  Bitboard m_pieces[12] = {};
+  Bitboard m_occupancy[2] = {};
+  // Square to chess piece lookup kept in sync with the bitboards.
+  std::array<int, SQUARE_COUNT> m_squares;
+  // Piece lists, m_piece_index holds the position of a square in its list.
+  uint8_t m_piece_list[12][MAX_PIECE_COUNT];
+  uint8_t m_piece_count[12] = {};
+  uint8_t m_piece_index[SQUARE_COUNT];
+  int m_king_square[2] = {};
 
   int m_movingturn = WHITE;
 
-  bool m_white_short_castling_allowed = true;
-  bool m_white_long_castling_allowed = true;
-  bool m_black_short_castling_allowed = true;
-  bool m_black_long_castling_allowed = true;
+  int m_castling_rights = ALL_CASTLINGS;
 
   int m_doublestep_on_row = -1;
 
   int m_en_passant_col[2] = { -1, -1 };
+
+  uint64_t m_key = 0;
+
+  // Search plays moves in place, each search thread has its own Position.
+  std::array<UndoInfo, MAX_PLY> m_undo_stack;
+  int m_undo_count = 0;
 };
\ No newline at end of file
@@ -0,0 +1,600 @@
+#include "search.h"
+#include "movepick.h"
+#include "tt.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // Reading the clock on every node would cost more than the node itself.
+    // A stopped search returns within about this many nodes, well under a
+    // millisecond.
+    const int STOP_CHECK_INTERVAL = 1024;
+
+    // Captured material by chess piece, for delta pruning.
+    const float CAPTURE_VALUES[13] = {
+        5.0, 3.0, 3.0, 9.0, 0.0, 1.0,
+        5.0, 3.0, 3.0, 9.0, 0.0, 1.0,
+        0.0
+    };
+    // A capture is skipped in the quiescence search if even winning the piece
+    // plus this margin can't bring the score back to alpha (beta for black).
+    const float DELTA_MARGIN = 2.0;
+
+    // Width of the null windows of the principal variation search, smaller
+    // than any difference between evaluations that matters.
+    const float NULL_WINDOW = 0.01;
+    // Root window around the score of the previous iteration, doubled on every
+    // fail high or low.
+    const float ASPIRATION_WINDOW = 0.5;
+    const int ASPIRATION_MIN_DEPTH = 4;
+
+    // Null move pruning searches the pass this many plies shallower, one more
+    // from NULL_MOVE_DEEP_DEPTH on.
+    const int NULL_MOVE_MIN_DEPTH = 3;
+    const int NULL_MOVE_REDUCTION = 2;
+    const int NULL_MOVE_DEEP_DEPTH = 7;
+    // From this depth a null move cut-off is only trusted after a normal
+    // search without null moves confirms it.
+    const int NULL_MOVE_VERIFICATION_DEPTH = 8;
+
+    // Late move reductions start at this depth and move number, the first
+    // moves (hash move, good captures, killers) are never reduced.
+    const int LMR_MIN_DEPTH = 3;
+    const int LMR_MIN_MOVES = 3;
+
+    // Margins in pawns by remaining depth. Razoring drops into the quiescence
+    // search, futility pruning skips quiet moves, when the static evaluation
+    // plus the margin can't reach alpha (beta for black).
+    const int RAZOR_DEPTH = 2;
+    const float RAZOR_MARGIN[RAZOR_DEPTH + 1] = {0.0, 2.5, 3.5};
+    const int FUTILITY_DEPTH = 2;
+    const float FUTILITY_MARGIN[FUTILITY_DEPTH + 1] = {0.0, 1.0, 2.0};
+
+    // Mate scores count the depth left at the mate, the table keeps them
+    // relative to the stored node so they stay right when read at another depth.
+    float value_to_tt(float p_value, int p_depth) {
+        if (p_value >= MATE_SCORE - MAX_PLY) {
+            return p_value - p_depth;
+        }
+        if (p_value <= -MATE_SCORE + MAX_PLY) {
+            return p_value + p_depth;
+        }
+        return p_value;
+    }
+
+    float value_from_tt(float p_value, int p_depth) {
+        if (p_value >= MATE_SCORE - MAX_PLY) {
+            return p_value + p_depth;
+        }
+        if (p_value <= -MATE_SCORE + MAX_PLY) {
+            return p_value - p_depth;
+        }
+        return p_value;
+    }
+}
+
+int reduction_table[MAX_SEARCH_DEPTH + 1][MAX_MOVES];
+
+void init_reductions(float p_base, float p_divisor) {
+    for (int depth = 0; depth <= MAX_SEARCH_DEPTH; depth++) {
+        for (int move_number = 0; move_number < MAX_MOVES; move_number++) {
+            float reduction = 0;
+            if (depth > 0 && move_number > 0) {
+                reduction = p_base + std::log((float)depth) * std::log((float)move_number) / p_divisor;
+            }
+            reduction_table[depth][move_number] = std::max(0, (int)reduction);
+        }
+    }
+}
+
+namespace {
+    struct ReductionTableInit {
+        ReductionTableInit() {
+            init_reductions();
+        }
+    } reduction_table_init;
+}
+
+int get_reduction(int depth, int move_number) {
+    int reduction = reduction_table[std::min(depth, MAX_SEARCH_DEPTH)][std::min(move_number, MAX_MOVES - 1)];
+    // always leave at least one ply
+    return std::min(reduction, depth - 2);
+}
+
+Search::Search(const Position& p_position, int p_thread_index, SearchSignals* p_signals)
+    : m_position(p_position), m_thread_index(p_thread_index), m_signals(p_signals) {
+    m_start = std::chrono::steady_clock::now();
+}
+
+double Search::get_elapsed() const {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+    return elapsed.count();
+}
+
+bool Search::should_stop() {
+    if (!m_stopped && m_nodes % STOP_CHECK_INTERVAL == 0) {
+        m_stopped = (m_signals && m_signals->stop.load(std::memory_order_relaxed))
+            || (!is_pondering() && m_limits.hard_time > 0 && get_elapsed() >= m_limits.hard_time);
+    }
+    return m_stopped;
+}
+
+bool Search::is_pondering() {
+    if (m_pondering && !(m_signals && m_signals->ponder.load(std::memory_order_relaxed))) {
+        m_pondering = false;
+        double elapsed = get_elapsed();
+        if (m_limits.soft_time > 0 && elapsed >= m_limits.soft_time) {
+            // pondered longer than a normal search would have taken, answer now
+            m_limits.hard_time = elapsed;
+        } else if (m_limits.hard_time > 0) {
+            m_limits.hard_time += elapsed;
+        }
+    }
+    return m_pondering;
+}
+
+MinmaxValue Search::think(const SearchLimits& p_limits) {
+    m_limits = p_limits;
+    m_start = std::chrono::steady_clock::now();
+    m_nodes = 0;
+    m_completed_depth = 0;
+    m_stopped = false;
+    m_pondering = m_limits.ponder;
+    m_ply = 0;
+    for (int ply = 0; ply < MAX_PLY; ply++) {
+        m_killers[ply][0] = Move();
+        m_killers[ply][1] = Move();
+        m_null_move[ply] = false;
+    }
+    m_null_move_allowed = true;
+    m_history.age();
+
+    MoveList root_moves;
+    m_position.generate_legal_moves(root_moves, true);
+    // no lines of an earlier search may outlive this one
+    m_lines.clear();
+    if (root_moves.size() == 0) {
+        return MinmaxValue(m_position.score_end_result(0), Move());
+    }
+    // answer with something even if the first iteration doesn't finish
+    MinmaxValue best = MinmaxValue(m_position.evaluate(), root_moves[0]);
+    int line_count = std::clamp(m_limits.multi_pv, 1, root_moves.size());
+
+    // every other helper skips the first iteration, so the threads are spread
+    // over two depths instead of racing through the same tree
+    int start_depth = std::min(1 + m_thread_index % 2, m_limits.max_depth);
+    for (int depth = start_depth; depth <= m_limits.max_depth; depth++) {
+        m_root_best = MinmaxValue();
+        m_excluded_root_moves.clear();
+        std::vector<PVLine> lines;
+        for (m_pv_index = 0; m_pv_index < line_count; m_pv_index++) {
+            float previous_value = m_pv_index < (int)m_lines.size() ? m_lines[m_pv_index].value : best.value;
+            MinmaxValue result = aspiration_search(depth, previous_value);
+            if (m_stopped) {
+                break;
+            }
+            PVLine line;
+            line.value = result.value;
+            if (m_pv_length[0] > 0 && m_pv[0][0] == result.move) {
+                line.moves.assign(m_pv[0], m_pv[0] + m_pv_length[0]);
+            } else {
+                line.moves.push_back(result.move);
+            }
+            extend_line(line, depth);
+            lines.push_back(line);
+            m_excluded_root_moves.push_back(result.move);
+        }
+        if (m_stopped) {
+            // a move that beat the window in the unfinished iteration was searched
+            // deeper than the last result
+            if (!m_root_best.move.is_null()) {
+                best = m_root_best;
+            }
+            break;
+        }
+        // a later line can come out ahead when its score fell outside the
+        // window of an earlier one
+        bool white = m_position.get_moving_player() == WHITE;
+        std::stable_sort(lines.begin(), lines.end(), [white](const PVLine& a, const PVLine& b) {
+            return white ? a.value > b.value : a.value < b.value;
+        });
+        m_lines = lines;
+        best = MinmaxValue(m_lines[0].value, m_lines[0].moves[0]);
+        m_completed_depth = depth;
+        // a forced mate won't get any better with more depth
+        if (std::abs(best.value) >= MATE_SCORE) {
+            break;
+        }
+        if (!is_pondering() && m_limits.soft_time > 0 && get_elapsed() >= m_limits.soft_time) {
+            break;
+        }
+    }
+    // alpha_beta() called on its own searches all root moves
+    m_pv_index = 0;
+    m_excluded_root_moves.clear();
+    return best;
+}
+
+MinmaxValue Search::aspiration_search(int depth, float p_previous_value) {
+    MinmaxValue alpha = MinmaxValue(std::numeric_limits<float>::lowest(), Move());
+    MinmaxValue beta = MinmaxValue(std::numeric_limits<float>::max(), Move());
+    // the score rarely moves far between iterations, a narrow window around
+    // the last one cuts more
+    float delta = ASPIRATION_WINDOW;
+    if (depth >= ASPIRATION_MIN_DEPTH && std::abs(p_previous_value) < MATE_SCORE) {
+        alpha.value = p_previous_value - delta;
+        beta.value = p_previous_value + delta;
+    }
+    while (true) {
+        MinmaxValue result = alpha_beta(depth, alpha, beta);
+        if (m_stopped) {
+            return result;
+        }
+        // outside the window the score is only a bound, widen that side and redo
+        if (result.value <= alpha.value && alpha.value != std::numeric_limits<float>::lowest()) {
+            delta *= 2;
+            alpha.value = delta > 8 * ASPIRATION_WINDOW ? std::numeric_limits<float>::lowest() : result.value - delta;
+        } else if (result.value >= beta.value && beta.value != std::numeric_limits<float>::max()) {
+            delta *= 2;
+            beta.value = delta > 8 * ASPIRATION_WINDOW ? std::numeric_limits<float>::max() : result.value + delta;
+        } else {
+            return result;
+        }
+    }
+}
+
+MinmaxValue Search::alpha_beta(int depth, MinmaxValue alpha, MinmaxValue beta) {
+    m_pv_length[m_ply] = m_ply;
+    if (depth == 0) {
+        return quiescence(alpha, beta);
+    }
+    m_nodes++;
+    if (should_stop()) {
+        return MinmaxValue(0, Move());
+    }
+
+    uint64_t key = m_position.get_key();
+    float alpha_start = alpha.value;
+    float beta_start = beta.value;
+    Move hash_move;
+    TTEntry entry;
+    if (transposition_table.probe(key, entry)) {
+        hash_move = entry.move;
+        float value = value_from_tt(entry.value, depth);
+        // The root always searches, it has to return a move. Other nodes with an
+        // open window are on the line the search reports, a cut-off there would
+        // end that line.
+        bool pv_node = beta.value - alpha.value > 2 * NULL_WINDOW;
+        if (m_ply > 0 && !pv_node && entry.depth >= depth && (entry.bound == BOUND_EXACT
+                || (entry.bound == BOUND_LOWER && value >= beta.value)
+                || (entry.bound == BOUND_UPPER && value <= alpha.value))) {
+            return MinmaxValue(value, entry.move);
+        }
+    }
+
+    int player = m_position.get_moving_player();
+    bool maximizing_player = player == WHITE;
+    bool in_check = m_position.is_in_check(player);
+    float static_eval = in_check ? 0 : m_position.evaluate();
+    // margins mean nothing next to mate scores
+    float own_bound = maximizing_player ? alpha.value : beta.value;
+    bool can_prune = m_ply > 0 && !in_check && std::abs(own_bound) < MATE_SCORE - MAX_PLY;
+
+    // Razoring: this far behind near the leaves only captures can help, so
+    // the quiescence search decides.
+    if (can_prune && depth <= RAZOR_DEPTH) {
+        float margin = RAZOR_MARGIN[depth];
+        if (maximizing_player ? static_eval + margin <= alpha.value : static_eval - margin >= beta.value) {
+            MinmaxValue value = quiescence(alpha, beta);
+            if (m_stopped || (maximizing_player ? value.value <= alpha.value : value.value >= beta.value)) {
+                return value;
+            }
+        }
+    }
+
+    if (m_ply > 0 && !in_check && can_null_move(depth, static_eval, alpha, beta)) {
+        // If passing the turn still leaves the score above beta (below alpha for
+        // black), some real move will too and the node can be cut.
+        MinmaxValue null_alpha = maximizing_player ? MinmaxValue(beta.value - NULL_WINDOW, Move()) : alpha;
+        MinmaxValue null_beta = maximizing_player ? beta : MinmaxValue(alpha.value + NULL_WINDOW, Move());
+        int reduction = depth >= NULL_MOVE_DEEP_DEPTH ? NULL_MOVE_REDUCTION + 1 : NULL_MOVE_REDUCTION;
+
+        m_position.make_null_move();
+        m_ply++;
+        m_null_move[m_ply] = true;
+        MinmaxValue null_result = alpha_beta(std::max(depth - 1 - reduction, 0), null_alpha, null_beta);
+        m_null_move[m_ply] = false;
+        m_ply--;
+        m_position.unmake_null_move();
+        if (m_stopped) {
+            return null_result;
+        }
+
+        bool cut = maximizing_player ? null_result.value >= beta.value : null_result.value <= alpha.value;
+        if (cut && depth >= NULL_MOVE_VERIFICATION_DEPTH) {
+            // zugzwang positions fool the null move, deep cuts are checked with a
+            // normal reduced search
+            bool null_move_allowed = m_null_move_allowed;
+            m_null_move_allowed = false;
+            MinmaxValue verification = alpha_beta(depth - reduction, null_alpha, null_beta);
+            m_null_move_allowed = null_move_allowed;
+            if (m_stopped) {
+                return verification;
+            }
+            cut = maximizing_player ? verification.value >= beta.value : verification.value <= alpha.value;
+        }
+        // a mate found after passing is no proof of a mate
+        if (cut) {
+            return MinmaxValue(maximizing_player ? beta.value : alpha.value, Move());
+        }
+    }
+
+    // Futility pruning: quiet moves can't make up the difference either.
+    bool prune_quiets = false;
+    float futility_value = 0;
+    if (can_prune && depth <= FUTILITY_DEPTH) {
+        futility_value = maximizing_player ? static_eval + FUTILITY_MARGIN[depth] : static_eval - FUTILITY_MARGIN[depth];
+        prune_quiets = maximizing_player ? futility_value <= alpha.value : futility_value >= beta.value;
+    }
+
+    // the razoring and null move verification searches ran at this ply too,
+    // their lines are no line of this node
+    m_pv_length[m_ply] = m_ply;
+
+    // moves are generated stage by stage, so a cut-off skips the rest
+    MovePicker picker(m_position, hash_move, m_killers[m_ply], &m_history);
+    MinmaxValue best_move = search_moves(picker, depth, alpha, beta, prune_quiets, futility_value);
+    if (m_stopped) {
+        return best_move;
+    }
+    if (best_move.move.is_null()) {
+        best_move = MinmaxValue(m_position.score_end_result(depth), Move());
+    }
+
+    int bound = BOUND_EXACT;
+    if (best_move.value <= alpha_start) {
+        bound = BOUND_UPPER;
+    } else if (best_move.value >= beta_start) {
+        bound = BOUND_LOWER;
+    }
+    // the root searched without the moves of earlier lines is no result for the position
+    if (m_ply > 0 || m_pv_index == 0) {
+        transposition_table.store(key, depth, bound, value_to_tt(best_move.value, depth), best_move.move);
+    }
+    return best_move;
+}
+
+bool Search::can_null_move(int depth, float p_static_eval, const MinmaxValue& alpha, const MinmaxValue& beta) {
+    int player = m_position.get_moving_player();
+    if (depth < NULL_MOVE_MIN_DEPTH || !m_null_move_allowed || m_null_move[m_ply]) {
+        return false;
+    }
+    // with only king and pawns passing would often be the best move (zugzwang)
+    Bitboard pawns_and_king = m_position.get_pieces(get_player_piece(player, wP)) | m_position.get_pieces(get_player_piece(player, wK));
+    if ((m_position.get_occupancy(player) & ~pawns_and_king) == 0) {
+        return false;
+    }
+    float bound = player == WHITE ? beta.value : alpha.value;
+    if (std::abs(bound) >= MATE_SCORE - MAX_PLY) {
+        return false;
+    }
+    // only worth trying when the side to move is already doing well
+    return player == WHITE ? p_static_eval >= beta.value : p_static_eval <= alpha.value;
+}
+
+MinmaxValue Search::quiescence(MinmaxValue alpha, MinmaxValue beta) {
+    m_pv_length[m_ply] = m_ply;
+    m_nodes++;
+    if (should_stop()) {
+        return MinmaxValue(0, Move());
+    }
+    int player = m_position.get_moving_player();
+    bool maximizing_player = player == WHITE;
+    bool in_check = m_position.is_in_check(player);
+    if (m_ply >= MAX_PLY - 1) {
+        return MinmaxValue(m_position.evaluate(), Move());
+    }
+
+    // Stand pat: the side to move doesn't have to capture, so the static
+    // evaluation is a bound on the score. In check every evasion is searched.
+    float stand_pat = 0;
+    float best_value = maximizing_player ? std::numeric_limits<float>::lowest() : std::numeric_limits<float>::max();
+    if (!in_check) {
+        stand_pat = m_position.evaluate();
+        best_value = stand_pat;
+        if (maximizing_player) {
+            if (stand_pat >= beta.value) {
+                return MinmaxValue(stand_pat, Move());
+            }
+            alpha.value = std::max(alpha.value, stand_pat);
+        } else {
+            if (stand_pat <= alpha.value) {
+                return MinmaxValue(stand_pat, Move());
+            }
+            beta.value = std::min(beta.value, stand_pat);
+        }
+    }
+
+    MovePicker picker(m_position);
+    Move best_move;
+    int move_count = 0;
+    for (Move move = picker.next_move(); !move.is_null(); move = picker.next_move()) {
+        move_count++;
+        if (!in_check && move.get_type() != Move::PROMOTION) {
+            float gain = CAPTURE_VALUES[m_position.get_piece(move.get_end_pos()[0], move.get_end_pos()[1])];
+            if (move.get_type() == Move::EN_PASSANT) {
+                gain = CAPTURE_VALUES[wP];
+            }
+            if (maximizing_player ? stand_pat + gain + DELTA_MARGIN <= alpha.value : stand_pat - gain - DELTA_MARGIN >= beta.value) {
+                continue;
+            }
+        }
+
+        m_position.make_move(move);
+        m_ply++;
+        MinmaxValue current_move = quiescence(alpha, beta);
+        m_ply--;
+        m_position.unmake_move();
+        if (m_stopped) {
+            break;
+        }
+        if (maximizing_player) {
+            if (current_move.value > best_value) {
+                best_value = current_move.value;
+                best_move = move;
+            }
+            alpha.value = std::max(alpha.value, current_move.value);
+        } else {
+            if (current_move.value < best_value) {
+                best_value = current_move.value;
+                best_move = move;
+            }
+            beta.value = std::min(beta.value, current_move.value);
+        }
+        if (beta.value <= alpha.value) {
+            break;
+        }
+    }
+    if (in_check && move_count == 0) {
+        return MinmaxValue(m_position.score_end_result(0), Move());
+    }
+    return MinmaxValue(best_value, best_move);
+}
+
+MinmaxValue Search::search_moves(MovePicker& p_picker, int depth, MinmaxValue alpha, MinmaxValue beta, bool p_prune_quiets, float p_futility_value) {
+    int player = m_position.get_moving_player();
+    bool maximizing_player = player == WHITE;
+    bool in_check = m_position.is_in_check(player);
+    float best_value = maximizing_player ? std::numeric_limits<float>::lowest() : std::numeric_limits<float>::max();
+    Move best_move;
+    int move_count = 0;
+    for (Move move = p_picker.next_move(); !move.is_null(); move = p_picker.next_move()) {
+        if (m_ply == 0 && is_excluded_root_move(move)) {
+            continue;
+        }
+        bool quiet = !m_position.is_capture(move) && move.get_type() != Move::PROMOTION;
+        m_position.make_move(move);
+        bool gives_check = m_position.is_in_check(m_position.get_moving_player());
+        if (p_prune_quiets && quiet && !gives_check && move_count > 0) {
+            m_position.unmake_move();
+            // the skipped move is taken to score the futility value at best
+            best_value = maximizing_player ? std::max(best_value, p_futility_value) : std::min(best_value, p_futility_value);
+            continue;
+        }
+        m_ply++;
+        MinmaxValue current_move;
+        if (move_count == 0) {
+            current_move = alpha_beta(depth - 1, alpha, beta);
+        } else {
+            // With good ordering the first move is the best one. The others get a
+            // null window at alpha (beta for black), which only proves they are
+            // no better, and a full search only if that proof fails.
+            MinmaxValue null_alpha = maximizing_player ? alpha : MinmaxValue(beta.value - NULL_WINDOW, Move());
+            MinmaxValue null_beta = maximizing_player ? MinmaxValue(alpha.value + NULL_WINDOW, Move()) : beta;
+
+            // late quiet moves are unlikely to be good, they get a shallower search
+            int reduction = 0;
+            if (depth >= LMR_MIN_DEPTH && move_count >= LMR_MIN_MOVES && quiet && !in_check && !gives_check) {
+                reduction = get_reduction(depth, move_count);
+            }
+            current_move = alpha_beta(depth - 1 - reduction, null_alpha, null_beta);
+            bool improves = maximizing_player ? current_move.value > alpha.value : current_move.value < beta.value;
+            if (!m_stopped && reduction > 0 && improves) {
+                current_move = alpha_beta(depth - 1, null_alpha, null_beta);
+            }
+            if (!m_stopped && current_move.value > alpha.value && current_move.value < beta.value) {
+                current_move = alpha_beta(depth - 1, alpha, beta);
+            }
+        }
+        move_count++;
+        m_ply--;
+        m_position.unmake_move();
+        if (m_stopped) {
+            break;
+        }
+        bool better = maximizing_player ? current_move.value > alpha.value : current_move.value < beta.value;
+        if (better) {
+            update_pv(move);
+            if (m_ply == 0 && m_pv_index == 0) {
+                m_root_best = MinmaxValue(current_move.value, move);
+            }
+        }
+        if (maximizing_player) {
+            if (current_move.value > best_value) {
+                best_value = current_move.value;
+                best_move = move;
+            }
+            if (better) {
+                alpha.value = current_move.value;
+                alpha.move = move;
+            }
+        } else {
+            if (current_move.value < best_value) {
+                best_value = current_move.value;
+                best_move = move;
+            }
+            if (better) {
+                beta.value = current_move.value;
+                beta.move = move;
+            }
+        }
+        if (beta.value <= alpha.value) {
+            if (!m_position.is_capture(move) && move.get_type() != Move::PROMOTION) {
+                update_quiet_stats(move, depth);
+            }
+            break;
+        }
+    }
+    return MinmaxValue(best_value, best_move);
+}
+
+void Search::update_pv(const Move& p_move) {
+    m_pv[m_ply][m_ply] = p_move;
+    for (int ply = m_ply + 1; ply < m_pv_length[m_ply + 1]; ply++) {
+        m_pv[m_ply][ply] = m_pv[m_ply + 1][ply];
+    }
+    m_pv_length[m_ply] = std::max(m_pv_length[m_ply + 1], m_ply + 1);
+}
+
+void Search::extend_line(PVLine& p_line, int depth) const {
+    Position position = m_position;
+    for (const Move& move : p_line.moves) {
+        position.make_move(move);
+    }
+    while ((int)p_line.moves.size() < depth) {
+        Move move = get_hash_move(position);
+        if (move.is_null()) {
+            break;
+        }
+        position.make_move(move);
+        p_line.moves.push_back(move);
+    }
+}
+
+bool Search::is_excluded_root_move(const Move& p_move) const {
+    for (const Move& move : m_excluded_root_moves) {
+        if (move == p_move) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Search::update_quiet_stats(const Move& p_move, int depth) {
+    Move* killers = m_killers[m_ply];
+    if (killers[0] != p_move) {
+        killers[1] = killers[0];
+        killers[0] = p_move;
+    }
+    // deep cut-offs say more about a move than ones near the leaves
+    m_history.add(m_position.get_moving_player(), p_move, depth * depth);
+}
+
+Move get_hash_move(const Position& p_position) {
+    TTEntry entry;
+    if (transposition_table.probe(p_position.get_key(), entry) && !entry.move.is_null() && p_position.is_legal(entry.move)) {
+        return entry.move;
+    }
+    return Move();
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include "position.h"
+#include "movepick.h"
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+// Deepest iteration a search may start.
+const int MAX_SEARCH_DEPTH = 64;
+
+// Late move reductions in plies, indexed by remaining depth and the number
+// of moves searched before in the node.
+extern int reduction_table[MAX_SEARCH_DEPTH + 1][MAX_MOVES];
+// Fills reduction_table with p_base + ln(depth) * ln(move number) / p_divisor,
+// a larger base or smaller divisor reduces more. Done at startup with the
+// defaults, call again before searching to tune.
+void init_reductions(float p_base = 0.75f, float p_divisor = 2.25f);
+// Reduction for a move, leaves at least one ply to search.
+int get_reduction(int depth, int move_number);
+
+// When a search has to return. Times are in seconds from the start, 0 means
+// no limit.
+struct SearchLimits {
+  int max_depth = MAX_SEARCH_DEPTH;
+  // no new iteration is started after this, the next one would most likely
+  // not finish anyway
+  double soft_time = 0;
+  // the running iteration is abandoned at this point
+  double hard_time = 0;
+  // Searching on the opponent's time: no time limits until SearchSignals
+  // ponder is cleared. Time spent pondering counts toward soft_time, past it
+  // the search returns right away, otherwise the hard time counts from the
+  // ponder hit.
+  bool ponder = false;
+  // Number of best root moves to find, each with its own score and line.
+  int multi_pv = 1;
+
+  // Limits for a budget of p_seconds per move.
+  static SearchLimits for_move_time(double p_seconds) {
+    SearchLimits limits;
+    limits.soft_time = p_seconds * 0.5;
+    limits.hard_time = p_seconds;
+    return limits;
+  }
+};
+
+// A root move with its score and the moves the search expects to follow,
+// moves[0] is the root move.
+struct PVLine {
+  float value = 0;
+  std::vector<Move> moves;
+};
+
+// Flags a running search polls every few nodes, shared by all threads of a
+// parallel search.
+struct SearchSignals {
+  // return as soon as possible
+  std::atomic<bool> stop = false;
+  // still pondering, cleared on a ponder hit
+  std::atomic<bool> ponder = false;
+};
+
+// Alpha-beta search on its own copy of a position. Scores are from white's
+// point of view like evaluate(), white maximizes and black minimizes.
+class Search {
+public:
+  // Thread 0 is the main thread of a parallel search, the others are
+  // helpers (see ThreadPool).
+  Search(const Position& p_position, int p_thread_index = 0, SearchSignals* p_signals = nullptr);
+
+  // Searches p_position from now on, the move ordering state is kept.
+  void set_position(const Position& p_position) { m_position = p_position; }
+
+  // Iterative deepening: searches depth 1, 2, 3, ... until the limits are
+  // reached and returns the result of the deepest finished iteration, or the
+  // best move so far of an iteration cut short by the stop signal or the
+  // hard time.
+  MinmaxValue think(const SearchLimits& p_limits);
+  // Fixed depth search of the position.
+  MinmaxValue alpha_beta(int depth, MinmaxValue alpha, MinmaxValue beta);
+
+  long long get_nodes() const { return m_nodes; }
+  // The SearchLimits multi_pv best root moves of the last finished
+  // iteration, best first. A line can end before the depth of that
+  // iteration when the table entries that continue it were replaced.
+  const std::vector<PVLine>& get_lines() const { return m_lines; }
+  // Depth of the last finished iteration of think().
+  int get_completed_depth() const { return m_completed_depth; }
+
+private:
+  // Searches the root with a window around the previous iteration's score,
+  // widening it until the score falls inside.
+  MinmaxValue aspiration_search(int depth, float p_previous_value);
+  // Whether null move pruning may be tried in the current node.
+  bool can_null_move(int depth, float p_static_eval, const MinmaxValue& alpha, const MinmaxValue& beta);
+  // Searches captures and promotions until the position is quiet, so the
+  // evaluation isn't taken in the middle of an exchange.
+  MinmaxValue quiescence(MinmaxValue alpha, MinmaxValue beta);
+  // Searches the moves of the picker, best move is null if it had none.
+  // With p_prune_quiets, quiet moves that don't give check are skipped after
+  // the first move and count as scoring p_futility_value.
+  MinmaxValue search_moves(MovePicker& p_picker, int depth, MinmaxValue alpha, MinmaxValue beta, bool p_prune_quiets = false, float p_futility_value = 0);
+  // Makes p_move followed by the line of the next ply the line of this ply.
+  void update_pv(const Move& p_move);
+  // Lines cut short below the root (razoring, quiescence) are continued with
+  // the hash moves up to p_depth moves.
+  void extend_line(PVLine& p_line, int depth) const;
+  bool is_excluded_root_move(const Move& p_move) const;
+  // Remembers a quiet move that caused a cut-off for the ordering of later nodes.
+  void update_quiet_stats(const Move& p_move, int depth);
+  // Checks the clock and the signals every STOP_CHECK_INTERVAL nodes.
+  bool should_stop();
+  // Whether the search still ponders, starts the clock on a ponder hit.
+  bool is_pondering();
+  double get_elapsed() const;
+
+  Position m_position;
+  int m_thread_index = 0;
+  SearchSignals* m_signals = nullptr;
+  SearchLimits m_limits;
+  std::chrono::steady_clock::time_point m_start;
+  long long m_nodes = 0;
+  int m_completed_depth = 0;
+  bool m_stopped = false;
+  bool m_pondering = false;
+  // Best root move of the running iteration, null until a move beats the
+  // root window.
+  MinmaxValue m_root_best;
+
+  // Multi-PV: every iteration searches the root once per line, leaving out
+  // the root moves of the lines found before.
+  std::vector<PVLine> m_lines;
+  int m_pv_index = 0;
+  MoveList m_excluded_root_moves;
+  // Triangular table of the best line from each ply, m_pv[ply] holds moves
+  // ply .. m_pv_length[ply] - 1.
+  Move m_pv[MAX_PLY][MAX_PLY];
+  int m_pv_length[MAX_PLY] = {};
+
+  // Move ordering state, every search thread has its own.
+  // Distance from the root of the node being searched.
+  int m_ply = 0;
+  // Two most recent quiet cut-off moves of each ply.
+  Move m_killers[MAX_PLY][2];
+  ButterflyHistory m_history;
+
+  // Whether the move into each ply was a null move, two in a row prove nothing.
+  bool m_null_move[MAX_PLY] = {};
+  // Off during the verification search of a null move cut-off.
+  bool m_null_move_allowed = true;
+};
+
+// Best move the transposition table knows for the position, null if none or
+// not legal there. After a search this is the reply it expects.
+Move get_hash_move(const Position& p_position);
@@ -0,0 +1,135 @@
+#include "threads.h"
+#include "tt.h"
+
+ThreadPool::ThreadPool(int p_thread_count) {
+    create_workers(p_thread_count);
+}
+
+ThreadPool::~ThreadPool() {
+    destroy_workers();
+}
+
+void ThreadPool::set_thread_count(int p_thread_count) {
+    p_thread_count = std::max(p_thread_count, 1);
+    if (p_thread_count == get_thread_count()) {
+        return;
+    }
+    destroy_workers();
+    create_workers(p_thread_count);
+}
+
+void ThreadPool::create_workers(int p_thread_count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_best_worker = 0;
+    for (int i = 0; i < std::max(p_thread_count, 1); i++) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->thread = std::thread(&ThreadPool::worker_loop, this, m_workers.back().get(), i, m_search_id);
+    }
+}
+
+void ThreadPool::destroy_workers() {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_start_condition.notify_all();
+    for (std::unique_ptr<Worker>& worker : m_workers) {
+        worker->thread.join();
+    }
+    m_workers.clear();
+    m_quit = false;
+}
+
+void ThreadPool::start(const Position& p_position, const SearchLimits& p_limits) {
+    wait();
+    transposition_table.new_search();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_signals.stop = false;
+        m_signals.ponder = p_limits.ponder;
+        m_position = p_position;
+        m_limits = p_limits;
+        m_running = (int)m_workers.size();
+        m_search_id++;
+    }
+    m_start_condition.notify_all();
+}
+
+MinmaxValue ThreadPool::stop() {
+    m_signals.stop = true;
+    return wait();
+}
+
+void ThreadPool::ponderhit() {
+    m_signals.ponder = false;
+}
+
+MinmaxValue ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_condition.wait(lock, [this]() { return m_running == 0; });
+    // a helper that got one iteration further has the better answer
+    int best_depth = -1;
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        // no search yet if nothing was ever started
+        Search* search = m_workers[i]->search.get();
+        if (search && search->get_completed_depth() > best_depth) {
+            best_depth = search->get_completed_depth();
+            m_best_worker = i;
+        }
+    }
+    return m_workers[m_best_worker]->result;
+}
+
+const std::vector<PVLine>& ThreadPool::get_lines() const {
+    static const std::vector<PVLine> no_lines;
+    Search* search = m_workers[m_best_worker]->search.get();
+    return search ? search->get_lines() : no_lines;
+}
+
+bool ThreadPool::is_searching() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_running > 0;
+}
+
+void ThreadPool::worker_loop(Worker* p_worker, int p_thread_index, int p_search_id) {
+    // created here so the thread's own memory holds its search state
+    std::unique_ptr<Search> search = std::make_unique<Search>(Position(), p_thread_index, &m_signals);
+    int search_id = p_search_id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        p_worker->search = std::move(search);
+    }
+
+    while (true) {
+        SearchLimits limits;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_condition.wait(lock, [this, search_id]() { return m_quit || m_search_id != search_id; });
+            if (m_quit) {
+                return;
+            }
+            search_id = m_search_id;
+            p_worker->search->set_position(m_position);
+            limits = m_limits;
+        }
+        // helpers have no time limits of their own, the main thread stops them
+        if (p_thread_index > 0) {
+            SearchLimits helper_limits;
+            helper_limits.max_depth = limits.max_depth;
+            helper_limits.multi_pv = limits.multi_pv;
+            limits = helper_limits;
+        }
+        MinmaxValue result = p_worker->search->think(limits);
+        if (p_thread_index == 0) {
+            m_signals.stop = true;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        p_worker->result = result;
+        m_running--;
+        if (m_running == 0) {
+            m_done_condition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "search.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Search threads that live as long as the pool and sleep between searches.
+// A search is Lazy SMP: every thread searches the same position and they
+// share what they find through the transposition table. Thread 0 is the
+// main thread, its limits decide when the search ends. The helpers start at
+// different depths so they don't all search the same nodes.
+//
+// Every thread keeps its own Search, so its history table and stacks stay
+// warm in that thread's cache from one move to the next.
+class ThreadPool {
+public:
+  ThreadPool(int p_thread_count);
+  // Stops a running search and joins the threads.
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Stops a running search first, its result is lost.
+  void set_thread_count(int p_thread_count);
+  int get_thread_count() const { return (int)m_workers.size(); }
+
+  // Starts searching p_position in the background and returns at once.
+  // A search that is still running is waited for first. With p_limits.ponder
+  // the search runs until stop() or ponderhit().
+  void start(const Position& p_position, const SearchLimits& p_limits);
+  // Makes the threads return within a few thousand nodes and returns the
+  // best move found so far. Does nothing but wait() when no search runs.
+  MinmaxValue stop();
+  // The expected move was played: the ponder search goes on as a normal
+  // search under its time limits.
+  void ponderhit();
+  // Blocks until the threads are done and returns the deepest result.
+  MinmaxValue wait();
+  // Lines of the thread whose result wait() returned, see Search::get_lines().
+  // Call after wait(), valid until the next start().
+  const std::vector<PVLine>& get_lines() const;
+  // Whether any thread is still searching.
+  bool is_searching() const;
+
+private:
+  struct Worker {
+    std::thread thread;
+    std::unique_ptr<Search> search;
+    MinmaxValue result;
+  };
+
+  void create_workers(int p_thread_count);
+  void destroy_workers();
+  // p_search_id is the last search the new thread must not run.
+  void worker_loop(Worker* p_worker, int p_thread_index, int p_search_id);
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  // worker whose result wait() returned last
+  size_t m_best_worker = 0;
+  SearchSignals m_signals;
+
+  // Guards everything below, the workers sleep on m_start_condition until
+  // m_search_id changes.
+  mutable std::mutex m_mutex;
+  std::condition_variable m_start_condition;
+  std::condition_variable m_done_condition;
+  Position m_position;
+  SearchLimits m_limits;
+  int m_search_id = 0;
+  int m_running = 0;
+  bool m_quit = false;
+};
@@ -0,0 +1,72 @@
+#include "tt.h"
+#include <bit>
+
+TranspositionTable transposition_table(DEFAULT_HASH_SIZE_MB);
+
+namespace {
+    // data of a slot: move (16 bits), value (32), depth (8), bound (2), generation (6)
+    uint64_t pack(Move p_move, float p_value, int p_depth, int p_bound, uint64_t p_generation) {
+        return (uint64_t)p_move.get_data()
+            | ((uint64_t)std::bit_cast<uint32_t>(p_value) << 16)
+            | ((uint64_t)(p_depth & 0xFF) << 48)
+            | ((uint64_t)p_bound << 56)
+            | (p_generation << 58);
+    }
+
+    int unpack_depth(uint64_t p_data) { return (int)((p_data >> 48) & 0xFF); }
+    int unpack_bound(uint64_t p_data) { return (int)((p_data >> 56) & 3); }
+    uint64_t unpack_generation(uint64_t p_data) { return p_data >> 58; }
+}
+
+TranspositionTable::TranspositionTable(size_t p_megabytes) {
+    resize(p_megabytes);
+}
+
+void TranspositionTable::resize(size_t p_megabytes) {
+    // largest power of two that fits, so the index is a mask of the key
+    size_t count = 1;
+    while (count * 2 * sizeof(Slot) <= p_megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+    m_slots = std::make_unique<Slot[]>(count);
+    m_mask = count - 1;
+    m_size_mb = p_megabytes;
+}
+
+void TranspositionTable::clear() {
+    for (uint64_t i = 0; i <= m_mask; i++) {
+        m_slots[i].check.store(0, std::memory_order_relaxed);
+        m_slots[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool TranspositionTable::probe(uint64_t p_key, TTEntry& p_entry) const {
+    const Slot& slot = m_slots[p_key & m_mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != p_key || unpack_bound(data) == BOUND_NONE) {
+        return false;
+    }
+    p_entry.move = Move::from_data((uint16_t)data);
+    p_entry.value = std::bit_cast<float>((uint32_t)(data >> 16));
+    p_entry.depth = unpack_depth(data);
+    p_entry.bound = unpack_bound(data);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t p_key, int p_depth, int p_bound, float p_value, Move p_move) {
+    Slot& slot = m_slots[p_key & m_mask];
+    uint64_t old_data = slot.data.load(std::memory_order_relaxed);
+    bool same_position = (slot.check.load(std::memory_order_relaxed) ^ old_data) == p_key;
+    // keep deeper results of the current search unless they are for this position
+    if (!same_position && unpack_generation(old_data) == m_generation && unpack_depth(old_data) > p_depth) {
+        return;
+    }
+    // a bound without a move keeps the move found earlier
+    if (same_position && p_move.is_null()) {
+        p_move = Move::from_data((uint16_t)old_data);
+    }
+    uint64_t data = pack(p_move, p_value, p_depth, p_bound, m_generation);
+    slot.check.store(p_key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
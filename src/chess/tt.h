@@ -0,0 +1,49 @@
+#pragma once
+#include "move.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Size of the transposition table when nothing else is set.
+const int DEFAULT_HASH_SIZE_MB = 64;
+
+// What the stored value says about the real value of the position.
+enum { BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT };
+
+struct TTEntry {
+  Move move;
+  float value = 0;
+  int depth = 0;
+  int bound = BOUND_NONE;
+};
+
+// Search results by Zobrist key, shared by all search threads without locks.
+// A slot holds key ^ data next to data, so a slot half written by another
+// thread fails the key check and reads as a miss instead of a wrong result.
+class TranspositionTable {
+public:
+  TranspositionTable(size_t p_megabytes);
+
+  // Drops all entries. Must not be called while a search runs.
+  void resize(size_t p_megabytes);
+  void clear();
+  size_t get_size_mb() const { return m_size_mb; }
+  // Entries of earlier searches are replaced first.
+  void new_search() { m_generation = (m_generation + 1) & 63; }
+
+  bool probe(uint64_t p_key, TTEntry& p_entry) const;
+  void store(uint64_t p_key, int p_depth, int p_bound, float p_value, Move p_move);
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> check = 0;
+    std::atomic<uint64_t> data = 0;
+  };
+
+  std::unique_ptr<Slot[]> m_slots;
+  uint64_t m_mask = 0;
+  size_t m_size_mb = 0;
+  uint64_t m_generation = 0;
+};
+
+extern TranspositionTable transposition_table;
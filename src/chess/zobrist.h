@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+// Random numbers for Zobrist hashing. The key of a position is the XOR of
+// the numbers of everything on it, so a move only needs to XOR out what
+// changed and XOR in the new state.
+struct ZobristKeys {
+  uint64_t pieces[12][64];
+  uint64_t castling[16];
+  uint64_t en_passant[8];
+  uint64_t black_to_move;
+};
+
+// splitmix64 with a fixed seed, the keys are built at compile time and are
+// identical on every run.
+constexpr ZobristKeys make_zobrist_keys() {
+  ZobristKeys keys = {};
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  auto next = [&state]() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  };
+  for (int piece = 0; piece < 12; piece++) {
+    for (int square = 0; square < 64; square++) {
+      keys.pieces[piece][square] = next();
+    }
+  }
+  // a combination of rights hashes the same as its single rights together
+  uint64_t single_rights[4] = {next(), next(), next(), next()};
+  for (int rights = 0; rights < 16; rights++) {
+    for (int i = 0; i < 4; i++) {
+      if (rights & (1 << i)) {
+        keys.castling[rights] ^= single_rights[i];
+      }
+    }
+  }
+  for (int col = 0; col < 8; col++) {
+    keys.en_passant[col] = next();
+  }
+  keys.black_to_move = next();
+  return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST = make_zobrist_keys();
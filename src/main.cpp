@@ -1,8 +1,12 @@
 #include "chess/position.h"
 #include "chess/move.h"
+#include "chess/tt.h"
+#include "chess/search.h"
+#include "chess/threads.h"
 #include "renderer/renderer.h"
 #include <imgui.h>
-#include <future>
+#include <algorithm>
+#include <thread>
 
 const int MAX_HISTORY_SIZE = 10;
 struct HistoryInfo {
@@ -25,14 +29,11 @@ void update_history(const Position p_position, const Move p_move) {
     history.push_back(HistoryInfo(p_position, p_move));
 }
 
-// This helper function could eventually be moved to some better place
-template<typename T>
-bool is_ready(std::future<T> const& f)
-{
-    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
-}
-
-std::future<MinmaxValue> minmax_result;
+// Whether the AI's search was started and its move not yet played.
+bool ai_thinking = false;
+// Whether the AI searches the position after ponder_move on the human's time.
+bool pondering = false;
+Move ponder_move;
 
 bool moved = false;
 
@@ -43,6 +44,12 @@ std::array<int, 2> promotable_coords = {-1, -1};
 float black_score = 0.0;
 float white_score = 0.0;
 
+// Settings
+int hash_size_mb = DEFAULT_HASH_SIZE_MB;
+float ai_time_budget = 1.0f;
+int ai_thread_count = std::max(1, (int)std::thread::hardware_concurrency());
+bool ponder_enabled = true;
+
 //Benchmark
 bool show_fps = false;
 bool show_ai_process_time = false;
@@ -56,9 +63,11 @@ int current_frame = 0;
 int main() {
     Renderer renderer = Renderer(1280, 720);
     Position position;
+    // the AI searches in the background while the board keeps rendering
+    ThreadPool thread_pool(ai_thread_count);
 
-    vector<Move> moves;
-    moves = position.generate_legal_moves(whiteAI);
+    MoveList moves;
+    position.generate_legal_moves(moves, whiteAI);
     position.render_legal_moves(moves);
     position.render_board();
     char coords[5] = "";
@@ -101,7 +110,7 @@ int main() {
                 promotable_coords[1] = -1;
                 position.end_turn();
                 moves.clear();
-                moves = position.generate_legal_moves();
+                position.generate_legal_moves(moves);
                 position.render_legal_moves(moves);
                 position.render_board();
             }
@@ -112,7 +121,7 @@ int main() {
                 promotable_coords[1] = -1;
                 position.end_turn();
                 moves.clear();
-                moves = position.generate_legal_moves();
+                position.generate_legal_moves(moves);
                 position.render_legal_moves(moves);
                 position.render_board();
             }
@@ -123,7 +132,7 @@ int main() {
                 promotable_coords[1] = -1;
                 position.end_turn();
                 moves.clear();
-                moves = position.generate_legal_moves();
+                position.generate_legal_moves(moves);
                 position.render_legal_moves(moves);
                 position.render_board();
             }
@@ -134,7 +143,7 @@ int main() {
                 promotable_coords[1] = -1;
                 position.end_turn();
                 moves.clear();
-                moves = position.generate_legal_moves();
+                position.generate_legal_moves(moves);
                 position.render_legal_moves(moves);
                 position.render_board();
                 moved = true;
@@ -159,14 +168,15 @@ int main() {
             ImGui::Text(position.get_moving_player() == WHITE ? "White's turn" : "Black's turn");
 
             if (position.get_moving_player() == BLACK && blackAI || position.get_moving_player() == WHITE && whiteAI) {
-                MinmaxValue alpha = MinmaxValue(numeric_limits<float>::lowest(), Move({ 0,0 }, { 0,0 }));
-                MinmaxValue beta = MinmaxValue(numeric_limits<float>::max(), Move({ 0,0 }, { 0,0 }));
-                if (!minmax_result.valid()) {
+                if (!ai_thinking) {
                     ai_time_start = std::chrono::system_clock::now();
-                    minmax_result = std::async(&Position::minmax_alphabeta, &position, 4, alpha, beta, true);
+                    thread_pool.set_thread_count(ai_thread_count);
+                    thread_pool.start(position, SearchLimits::for_move_time(ai_time_budget));
+                    ai_thinking = true;
                 }
-                else if (is_ready(minmax_result)) {
-                    MinmaxValue minmax_val = minmax_result.get();
+                else if (!thread_pool.is_searching()) {
+                    MinmaxValue minmax_val = thread_pool.wait();
+                    ai_thinking = false;
                     ai_time_end = std::chrono::system_clock::now();
                     std::chrono::duration<double> elapsed_seconds = ai_time_end - ai_time_start;
                     ai_delta_time = elapsed_seconds.count();
@@ -185,10 +195,26 @@ int main() {
                     }
                     position.end_turn();
                     moves.clear();
-                    moves = position.generate_legal_moves(true);
+                    position.generate_legal_moves(moves, true);
                     position.render_legal_moves(moves);
                     position.render_board();
                     moved = true;
+
+                    // think on the human's time about the reply the search expects
+                    bool human_to_move = position.get_moving_player() == WHITE ? !whiteAI : !blackAI;
+                    ponder_move = get_hash_move(position);
+                    if (ponder_enabled && human_to_move && !ponder_move.is_null()) {
+                        Position ponder_position = position;
+                        ponder_position.make_move(ponder_move);
+                        SearchLimits limits = SearchLimits::for_move_time(ai_time_budget);
+                        limits.ponder = true;
+                        thread_pool.start(ponder_position, limits);
+                        pondering = true;
+                    }
+                }
+                // the search stops at once and its best move so far is played next frame
+                else if (ImGui::Button("Move now")) {
+                    thread_pool.stop();
                 }
 
             }
@@ -210,6 +236,18 @@ int main() {
                     }
                     if (valid_coords) {
                         Move move = Move(coords);
+                        if (pondering) {
+                            pondering = false;
+                            // promotions are only known after the piece is picked
+                            if (move.get_coords() == ponder_move.get_coords() && ponder_move.get_type() != Move::PROMOTION) {
+                                // the search goes on, already deep into the AI's reply
+                                thread_pool.ponderhit();
+                                ai_time_start = std::chrono::system_clock::now();
+                                ai_thinking = true;
+                            } else {
+                                thread_pool.stop();
+                            }
+                        }
                         std::cout<< (position.get_moving_player() == WHITE ? "White " : "Black ")<<"moved from to: "<<move.get_coords()<<std::endl;
                         update_history(position, move);
                         position.move(move);
@@ -218,7 +256,7 @@ int main() {
                         } else {
                             position.end_turn();
                             moves.clear();
-                            moves = position.generate_legal_moves();
+                            position.generate_legal_moves(moves);
                             position.render_legal_moves(moves);
                         }
 
@@ -229,6 +267,10 @@ int main() {
                 }
                 if (((blackAI || whiteAI) && history.size() > 1) || (!whiteAI && !blackAI && history.size() > 0)) {
                     if (ImGui::Button("Undo Move") && history.size() > 0) {
+                        if (pondering) {
+                            thread_pool.stop();
+                            pondering = false;
+                        }
                         if (blackAI || whiteAI && history.size() > 1) {
                             //undo two steps instead of one to get to the last move made by the human player
                             position = history[std::max<size_t>(history.size() - 2, 0)].position;
@@ -240,7 +282,7 @@ int main() {
                             history.pop_back();
                         }
                         moves.clear();
-                        moves = position.generate_legal_moves();
+                        position.generate_legal_moves(moves);
                         position.render_board();
                         moved = true;
                     }
@@ -259,6 +301,24 @@ int main() {
                     ImGui::BulletText("%s",result.c_str());
                 }
             }
+            if (ImGui::CollapsingHeader("Settings")) {
+                ImGui::InputInt("Hash size (MB)", &hash_size_mb);
+                hash_size_mb = std::clamp(hash_size_mb, 1, 4096);
+                // the table can't be reallocated under a running search
+                if (hash_size_mb != (int)transposition_table.get_size_mb() && !ai_thinking && !pondering) {
+                    transposition_table.resize(hash_size_mb);
+                }
+                ImGui::InputFloat("AI time per move (sec)", &ai_time_budget, 0.1f, 1.0f, "%.1f");
+                ai_time_budget = std::clamp(ai_time_budget, 0.1f, 60.0f);
+                // takes effect from the next AI move
+                ImGui::InputInt("AI threads", &ai_thread_count);
+                ai_thread_count = std::clamp(ai_thread_count, 1, 256);
+                ImGui::Checkbox("AI thinks on your time", &ponder_enabled);
+                if (!ponder_enabled && pondering) {
+                    thread_pool.stop();
+                    pondering = false;
+                }
+            }
             if (ImGui::CollapsingHeader("Benchmark")) {
                 ImGui::Checkbox("Show Fps", &show_fps);
                 if (whiteAI || blackAI) {
@@ -277,6 +337,25 @@ int main() {
                 ImGui::TextWrapped("Input the move you want to make into the text box and hit Enter. Input examples: 'a2a3', 'g8f6'.");
             }
         }
+        if (begin_game && ImGui::Button("New game")) {
+            // the running search belongs to the old game
+            thread_pool.stop();
+            ai_thinking = false;
+            pondering = false;
+            position = Position();
+            history.clear();
+            whiteAI = false;
+            blackAI = false;
+            begin_game = false;
+            white_score = 0.0;
+            black_score = 0.0;
+            promotable_coords = {-1, -1};
+            moves.clear();
+            position.generate_legal_moves(moves);
+            position.render_legal_moves(moves);
+            position.render_board();
+            moved = true;
+        }
         ImGui::End();
         renderer.render_board(info);
 
@@ -290,9 +369,6 @@ int main() {
             current_frame = 0;
         }
     }
-    if (minmax_result.valid() && !is_ready(minmax_result)) {
-        minmax_result.wait();
-    }
     renderer.destroy();
     return 0;
 }
\ No newline at end of file
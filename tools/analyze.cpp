@@ -0,0 +1,96 @@
+// Position analysis. Searches a position once and prints its best root moves,
+// each with its score and the line the engine expects to follow.
+//
+// usage: analyze [options] [fen]    start position by default
+// options: -l <lines>      number of best moves to show (default 3)
+//          -s <seconds>    search time (default 5)
+//          -d <depth>      search to this depth instead of a time
+//          -t <threads>    search threads
+//          -H <mb>         transposition table size
+#include "chess/threads.h"
+#include "chess/tt.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Score text from white's point of view in pawns, "+mate" when white mates.
+static std::string format_value(float p_value) {
+    std::ostringstream text;
+    if (std::abs(p_value) >= MATE_SCORE - MAX_PLY) {
+        text << (p_value > 0 ? "+" : "-") << "mate";
+    } else {
+        text << std::showpos << std::fixed << std::setprecision(2) << p_value;
+    }
+    return text.str();
+}
+
+int main(int argc, char** argv) {
+    int line_count = 3;
+    double seconds = 5;
+    int depth = 0;
+    int threads = 1;
+    int hash_megabytes = DEFAULT_HASH_SIZE_MB;
+    int arg = 1;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+        if (std::strcmp(argv[arg], "-l") == 0) {
+            line_count = std::max(1, std::atoi(argv[arg + 1]));
+        }
+        else if (std::strcmp(argv[arg], "-s") == 0) {
+            seconds = std::max(0.01, std::atof(argv[arg + 1]));
+        }
+        else if (std::strcmp(argv[arg], "-d") == 0) {
+            depth = std::clamp(std::atoi(argv[arg + 1]), 1, MAX_SEARCH_DEPTH);
+        }
+        else if (std::strcmp(argv[arg], "-t") == 0) {
+            threads = std::max(1, std::atoi(argv[arg + 1]));
+        }
+        else if (std::strcmp(argv[arg], "-H") == 0) {
+            hash_megabytes = std::max(1, std::atoi(argv[arg + 1]));
+        }
+        else {
+            break;
+        }
+    }
+
+    Position position;
+    if (arg < argc) {
+        std::string fen = argv[arg];
+        for (int i = arg + 1; i < argc; i++) {
+            fen += std::string(" ") + argv[i];
+        }
+        if (!position.set_fen(fen)) {
+            std::cout << "invalid fen: " << fen << std::endl;
+            return 1;
+        }
+    }
+
+    SearchLimits limits = SearchLimits::for_move_time(seconds);
+    if (depth > 0) {
+        limits = SearchLimits();
+        limits.max_depth = depth;
+    }
+    limits.multi_pv = line_count;
+    transposition_table.resize(hash_megabytes);
+    ThreadPool thread_pool(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    thread_pool.start(position, limits);
+    thread_pool.wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const std::vector<PVLine>& lines = thread_pool.get_lines();
+    for (size_t i = 0; i < lines.size(); i++) {
+        std::cout << i + 1 << ". " << std::setw(7) << format_value(lines[i].value) << " ";
+        for (const Move& move : lines[i].moves) {
+            std::cout << " " << move.get_coords(true);
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Time: " << elapsed.count() << " sec" << std::endl;
+    return 0;
+}
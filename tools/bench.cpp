@@ -0,0 +1,74 @@
+// Search benchmark. Runs the AI on a few positions and counts every heap
+// allocation made while it searches, which should stay at zero.
+//
+// usage: bench [depth]
+#include "chess/position.h"
+#include "chess/tt.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+static std::atomic<long long> allocation_count = 0;
+
+void* operator new(std::size_t p_size) {
+    allocation_count++;
+    void* ptr = std::malloc(p_size == 0 ? 1 : p_size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* p_ptr) noexcept {
+    std::free(p_ptr);
+}
+
+void operator delete(void* p_ptr, std::size_t) noexcept {
+    std::free(p_ptr);
+}
+
+// Opening lines played from the start position before searching.
+static const char* BENCH_LINES[] = {
+    "",
+    "e2e4 e7e5 g1f3 b8c6 f1c4 g8f6",
+    "d2d4 d7d5 c2c4 e7e6 b1c3 g8f6 c1g5 f8e7",
+    "e2e4 c7c5 g1f3 d7d6 d2d4 c5d4 f3d4 g8f6 b1c3 a7a6",
+};
+
+int main(int argc, char** argv) {
+    int depth = argc > 1 ? std::atoi(argv[1]) : 4;
+    long long total_allocations = 0;
+    double total_time = 0.0;
+
+    for (const char* line : BENCH_LINES) {
+        Position position;
+        std::string moves = line;
+        for (size_t i = 0; i + 4 <= moves.size(); i += 5) {
+            Move move(moves.substr(i, 4));
+            position.move(move);
+            position.end_turn();
+        }
+
+        MinmaxValue alpha = MinmaxValue(numeric_limits<float>::lowest(), Move({ 0,0 }, { 0,0 }));
+        MinmaxValue beta = MinmaxValue(numeric_limits<float>::max(), Move({ 0,0 }, { 0,0 }));
+
+        // every position starts from an empty table so the runs are comparable
+        transposition_table.clear();
+        long long allocations_before = allocation_count;
+        auto start = std::chrono::steady_clock::now();
+        MinmaxValue result = position.minmax_alphabeta(depth, alpha, beta);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        long long allocations = allocation_count - allocations_before;
+
+        total_allocations += allocations;
+        total_time += elapsed.count();
+        std::cout << "best move: " << result.move.get_coords() << " score: " << result.value
+                  << " time: " << elapsed.count() << " sec allocations: " << allocations << std::endl;
+    }
+
+    std::cout << "Total time: " << total_time << " sec" << std::endl;
+    std::cout << "Total heap allocations during search: " << total_allocations << std::endl;
+    return total_allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+// Move generator test and benchmark. Counts the leaf nodes of the legal move
+// tree to a fixed depth and compares them with known correct counts.
+//
+// usage: perft [options]                  run all reference positions
+//        perft [options] <depth> [fen]    print the count below every root move
+//                                         of one position (start position by
+//                                         default)
+// options: -t <threads>    split the root moves over this many threads
+//          -H <mb>         cache subtree counts in a hash table of this size
+#include "chess/position.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+struct PerftReference {
+    const char* name;
+    const char* fen;
+    // expected node counts for depth 1, 2, ...
+    std::vector<long long> counts;
+};
+
+// Standard positions covering castling, en passant, promotions and pins.
+static const PerftReference REFERENCES[] = {
+    {"start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        {20, 400, 8902, 197281, 4865609, 119060324}},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        {48, 2039, 97862, 4085603, 193690690}},
+    {"position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        {14, 191, 2812, 43238, 674624, 11030083, 178633661}},
+    {"position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        {6, 264, 9467, 422333, 15833292}},
+    {"position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        {44, 1486, 62379, 2103487, 89941194}},
+    {"position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        {46, 2079, 89890, 3894594, 164075551}},
+};
+
+// Subtree counts by Zobrist key and depth, shared by all threads without
+// locks. An entry holds key ^ data next to data, a half written entry from
+// another thread doesn't verify and is just a miss.
+class PerftHash {
+public:
+    PerftHash(size_t p_megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Entry) <= p_megabytes * 1024 * 1024) {
+            count *= 2;
+        }
+        m_entries = std::vector<Entry>(count);
+        m_mask = count - 1;
+    }
+
+    bool probe(uint64_t p_key, int p_depth, long long& p_nodes) const {
+        const Entry& entry = m_entries[p_key & m_mask];
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != p_key || (int)(data & 0xFF) != p_depth) {
+            return false;
+        }
+        p_nodes = (long long)(data >> 8);
+        return true;
+    }
+
+    void store(uint64_t p_key, int p_depth, long long p_nodes) {
+        Entry& entry = m_entries[p_key & m_mask];
+        uint64_t data = ((uint64_t)p_nodes << 8) | (uint64_t)p_depth;
+        entry.check.store(p_key ^ data, std::memory_order_relaxed);
+        entry.data.store(data, std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check = 0;
+        std::atomic<uint64_t> data = 0;
+    };
+    std::vector<Entry> m_entries;
+    uint64_t m_mask = 0;
+};
+
+struct PerftOptions {
+    int threads = 1;
+    PerftHash* hash = nullptr;
+};
+
+static long long perft(Position& position, int depth, PerftHash* hash) {
+    MoveList moves;
+    position.generate_legal_moves(moves, true);
+    // bulk counting, the leaves don't need to be played
+    if (depth == 1) {
+        return moves.size();
+    }
+    uint64_t key = 0;
+    long long nodes = 0;
+    if (hash) {
+        key = position.get_key();
+        if (hash->probe(key, depth, nodes)) {
+            return nodes;
+        }
+    }
+    for (const Move& move : moves) {
+        position.make_move(move);
+        nodes += perft(position, depth - 1, hash);
+        position.unmake_move();
+    }
+    if (hash) {
+        hash->store(key, depth, nodes);
+    }
+    return nodes;
+}
+
+// Counts below each root move, the threads take the next unsearched root
+// move until all are done.
+static std::vector<long long> perft_root(const Position& position, const MoveList& moves, int depth, const PerftOptions& options) {
+    std::vector<long long> counts(moves.size(), 1);
+    if (depth == 1) {
+        return counts;
+    }
+    std::atomic<int> next_move = 0;
+    auto worker = [&]() {
+        Position thread_position = position;
+        int i;
+        while ((i = next_move++) < moves.size()) {
+            thread_position.make_move(moves[i]);
+            counts[i] = perft(thread_position, depth - 1, options.hash);
+            thread_position.unmake_move();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < options.threads; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return counts;
+}
+
+static long long perft(const Position& position, int depth, const PerftOptions& options) {
+    MoveList moves;
+    position.generate_legal_moves(moves, true);
+    long long nodes = 0;
+    for (long long count : perft_root(position, moves, depth, options)) {
+        nodes += count;
+    }
+    return nodes;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point p_start) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - p_start;
+    return elapsed.count();
+}
+
+static int divide(const Position& position, int depth, const PerftOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    long long nodes = 0;
+    MoveList moves;
+    position.generate_legal_moves(moves, true);
+    std::vector<long long> counts = perft_root(position, moves, depth, options);
+    for (int i = 0; i < moves.size(); i++) {
+        nodes += counts[i];
+        std::cout << moves[i].get_coords(true) << ": " << counts[i] << std::endl;
+    }
+    double time = seconds_since(start);
+    std::cout << std::endl << "Nodes: " << nodes << std::endl;
+    std::cout << "Time: " << time << " sec" << std::endl;
+    std::cout << "Nodes per second: " << (long long)(nodes / std::max(time, 1e-9)) << std::endl;
+    return 0;
+}
+
+static int run_references(const PerftOptions& options) {
+    int failures = 0;
+    long long total_nodes = 0;
+    auto total_start = std::chrono::steady_clock::now();
+    for (const PerftReference& reference : REFERENCES) {
+        Position position;
+        position.set_fen(reference.fen);
+        int depth = (int)reference.counts.size();
+        long long expected = reference.counts[depth - 1];
+
+        auto start = std::chrono::steady_clock::now();
+        long long nodes = perft(position, depth, options);
+        double time = seconds_since(start);
+        total_nodes += nodes;
+
+        bool ok = nodes == expected;
+        failures += ok ? 0 : 1;
+        std::cout << (ok ? "ok     " : "FAILED ") << reference.name << " depth " << depth << ": " << nodes;
+        if (!ok) {
+            std::cout << " (expected " << expected << ")";
+        }
+        std::cout << " time: " << time << " sec" << std::endl;
+    }
+    double total_time = seconds_since(total_start);
+    std::cout << "Total nodes: " << total_nodes << " time: " << total_time << " sec nps: "
+              << (long long)(total_nodes / std::max(total_time, 1e-9)) << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    PerftOptions options;
+    size_t hash_megabytes = 0;
+    int arg = 1;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+        if (std::strcmp(argv[arg], "-t") == 0) {
+            options.threads = std::max(1, std::atoi(argv[arg + 1]));
+        }
+        else if (std::strcmp(argv[arg], "-H") == 0) {
+            hash_megabytes = (size_t)std::max(0, std::atoi(argv[arg + 1]));
+        }
+        else {
+            break;
+        }
+    }
+    PerftHash hash(hash_megabytes);
+    if (hash_megabytes > 0) {
+        options.hash = &hash;
+    }
+
+    if (arg >= argc) {
+        return run_references(options);
+    }
+    int depth = std::atoi(argv[arg]);
+    if (depth < 1) {
+        std::cout << "usage: perft [-t threads] [-H hash_mb] [depth [fen]]" << std::endl;
+        return 1;
+    }
+    Position position;
+    if (arg + 1 < argc) {
+        std::string fen = argv[arg + 1];
+        for (int i = arg + 2; i < argc; i++) {
+            fen += std::string(" ") + argv[i];
+        }
+        if (!position.set_fen(fen)) {
+            std::cout << "invalid fen: " << fen << std::endl;
+            return 1;
+        }
+    }
+    return divide(position, depth, options);
+}